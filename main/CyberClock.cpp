@@ -6,6 +6,7 @@
 #include "freertos/task.h"
 #include <ctime>
 #include <string>
+#include <string.h>
 #include <esp_sntp.h>
 #include <esp_log.h>
 #include <time.h>
@@ -13,6 +14,7 @@
 #include "settings.h"
 #include "cyberclock.h"
 #include "esp_wifi.h"
+#include "esp_timer.h"
 
 #include <algorithm>
 
@@ -25,36 +27,11 @@ bool is_wifi_connected() {
     return esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK;
 }
  
-struct ServoState {
-    int channel;            // Servo channel
-    int current_position;   // Current servo position
-    int target_position;    // Target servo position
-    int front_channel = -1; // Preceding task channel, -1 means no dependency
-    int state = -1;         // Task state: -1 not executed, 0 executing, 1 finished
-    bool smooth = false;    // Smooth movement
-};
-
 static bool servo_driver_available_ = false; // Is servo driver available
 
-std::vector<ServoState> servo_states_;
-
-// Function GetTargetPosition: sets clock_target_position_ based on abcd digits
-// Parameter 0xA means all off, 0xB means idle
-void CyberClock::GetTargetPosition(int a, int b, int c, int d) {
-    // Set target positions for each digit
-    for (int i = 0; i < 7; i++) {
-        clock_target_position_[i] = digits[a][i] ? segmentOn[i] + servo_offsets_[i] : segmentOff[i] + servo_offsets_[i];
-        clock_target_position_[i + 7] = digits[b][i] ? segmentOn[i + 7] + servo_offsets_[i + 7] : segmentOff[i + 7] + servo_offsets_[i + 7];
-        clock_target_position_[i + 14] = digits[c][i] ? segmentOn[i + 14] + servo_offsets_[i + 14] : segmentOff[i + 14] + servo_offsets_[i + 14];
-        clock_target_position_[i + 21] = digits[d][i] ? segmentOn[i + 21] + servo_offsets_[i + 21] : segmentOff[i + 21] + servo_offsets_[i + 21];
-    }
-
-    // Check for out-of-range values
-    for(int i=0;i<28;i++)
-    {
-        if(clock_target_position_[i] < 100)clock_target_position_[i] = 100; // Minimum value
-        if(clock_target_position_[i] > 550)clock_target_position_[i] = 550; // Maximum value   
-    }
+// Timestamp of motion trace records
+static uint32_t TraceTimeMs() {
+    return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
 // Initialize I2C bus
@@ -92,11 +69,11 @@ bool CyberClock::InitPCA9685(i2c_master_dev_handle_t* dev_handle, uint8_t addr)
 
     // Initialize registers
     uint8_t prescale = (uint8_t)(25000000 / (4096 * 50) - 1);
-    if (!SafeI2CWrite(*dev_handle, 0x00, 0x00) ||  // MODE1
-        !SafeI2CWrite(*dev_handle, 0x01, 0x04) ||  // MODE2
-        !SafeI2CWrite(*dev_handle, 0x00, 0x10) ||  // Sleep mode
+    if (!SafeI2CWrite(*dev_handle, 0x00, PCA9685_MODE1_AI) ||         // MODE1
+        !SafeI2CWrite(*dev_handle, 0x01, 0x04) ||                     // MODE2
+        !SafeI2CWrite(*dev_handle, 0x00, PCA9685_MODE1_AI | 0x10) ||  // Sleep mode
         !SafeI2CWrite(*dev_handle, 0xFE, prescale) ||
-        !SafeI2CWrite(*dev_handle, 0x00, 0x80)) {  // Wake up
+        !SafeI2CWrite(*dev_handle, 0x00, PCA9685_MODE1_AI | 0x80)) {  // Wake up
         ESP_LOGE(TAG, "Failed to initialize PCA9685 at 0x%02X", addr);
         return false;
     }
@@ -108,9 +85,13 @@ bool CyberClock::InitPCA9685(i2c_master_dev_handle_t* dev_handle, uint8_t addr)
 void CyberClock::InitializeCurrentPosition()
 {
     // Initialize current servo positions
-    for (int i = 0; i < 28; i++) {
-        clock_current_position_[i] = segmentOff[i] + servo_offsets_[i]; // Initial position is off
+    for (int i = 0; i < SERVO_CHANNEL_NUM; i++) {
+        servos_.position[i] = kServoProfiles[Servo_Mode_].OffPosition(i) + servos_.offset[i]; // Initial position is off
+        live_state_.position[i] = servos_.position[i];
+        live_state_.target[i] = servos_.position[i];
+        live_state_.offset[i] = servos_.offset[i];
     }
+    PublishState();
     ESP_LOGI(TAG, "Current servo positions initialized");
 }
 
@@ -121,8 +102,11 @@ bool CyberClock::InitializeServos() {
     }
 
     for (int retry = 0; retry < MAX_I2C_RETRIES; retry++) {
-        if (InitPCA9685(&dev_handle_h, PCA9685_ADDR_H) &&
-            InitPCA9685(&dev_handle_m, PCA9685_ADDR_M)) {
+        bool drivers_ready = true;
+        for (int i = 0; i < kDisplayTopology.driver_num && drivers_ready; i++) {
+            drivers_ready = InitPCA9685(&dev_handles_[i], kDisplayTopology.drivers[i].address);
+        }
+        if (drivers_ready) {
             servo_driver_available_ = true;
             ESP_LOGI(TAG, "Servo driver initialized successfully");
             return true;
@@ -153,245 +137,541 @@ void CyberClock::CheckSleepTime() {
         return;
 
     // If current time matches sleep start and not in idle, enter sleep (idle)
+    // The schedule only sets its own claim, a countdown or the user's display stays on top
+    int schedule_mode = display_arbiter_.ClaimedMode(DISPLAY_SOURCE_SCHEDULE);
     if( current_hour == sleep_start_hour_ && 
         current_minute == sleep_start_minute_ && 
-        current_mode_ != MODE_03_IDLE) {
+        schedule_mode != MODE_03_IDLE) {
         ESP_LOGW(TAG, "Entering sleep mode at %02d:%02d", current_hour, current_minute);
-        IdleClock(); // Enter sleep mode
+        UpdateIdleClock(); // Enter sleep mode
         return;
     }
 
     // If current time matches sleep end and is idle, exit sleep (normal clock)
     if( current_hour == sleep_end_hour_ && 
         current_minute == sleep_end_minute_ && 
-        current_mode_ == MODE_03_IDLE) {
+        schedule_mode == MODE_03_IDLE) {
         ESP_LOGW(TAG, "Exiting sleep mode at %02d:%02d", current_hour, current_minute);
-        ShowTime(); // Exit sleep mode
+        display_arbiter_.Claim(DISPLAY_SOURCE_SCHEDULE, MODE_00_NORMAL_CLOCK); // Exit sleep mode
         return;
     }
 }
 
-// Timer callback (with log rate control)
+// Timer callback: the deadline passed, wake the clock task. The timer daemon stays short
+// so its expiry handling never waits for servo moves.
 void CyberClock::TimerCallback(TimerHandle_t xTimer) {
     CyberClock* clock = static_cast<CyberClock*>(pvTimerGetTimerID(xTimer));
+    if (clock->clock_task_ != nullptr) {
+        xTaskNotifyGive(clock->clock_task_);
+    }
+}
+
+// Clock task body, never returns. Runs one tick per wakeup from the timer or a command.
+void CyberClock::Run() {
+    clock_task_ = xTaskGetCurrentTaskHandle();
+    ESP_LOGI(TAG, "Clock task running on core %d", (int)xPortGetCoreID());
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        RunTick();
+    }
+}
+
+// One clock tick (with log rate control)
+void CyberClock::RunTick() {
     static uint32_t last_warn_time = 0;
     const uint32_t now = xTaskGetTickCount();
 
-    // If servo driver is not available, limit log rate and exit
+    // Commands from the web server and the button, the clock state is only written here.
+    // Settings and saves apply even without a servo driver, only the display needs one.
+    // Any command drained means one of them woke the clock before its deadline.
+    const int64_t wake_us = esp_timer_get_time();
+    const bool command_wake = DrainCommands() > 0;
+    tick_monitor_.Wakeup(wake_us, command_wake);
+
+    // If servo driver is not available, limit log rate and stop; only a command wakes it again
     if (!servo_driver_available_) {
-        if (now - last_warn_time > pdMS_TO_TICKS(20000)) { // Log every 20 seconds
+        if (now - last_warn_time > pdMS_TO_TICKS(20000)) { // Log at most every 20 seconds
             ESP_LOGW(TAG, "Servo driver unavailable");
             last_warn_time = now;
         }
+        xTimerStop(clock_timer_, 0);
         return; // Ensure OnTimerTick is not called
     }
 
+    // An expiry that arrived while the previous tick was still moving servos is dropped
+    // when it was not due yet. Every mode shows the current state, nothing is replayed.
+    int elapsed_ticks = tick_monitor_.BeginTick(esp_timer_get_time());
+    if (elapsed_ticks == 0) {
+        return;
+    }
+    if (elapsed_ticks > 1) {
+        ESP_LOGW(TAG, "Clock tick late, %d ticks missed", elapsed_ticks - 1);
+    }
+
+    // Full speed and no light sleep until the servos have moved
+    PowerLockGuard power_lock(POWER_LOCK_MOTION);
+    // Woken for a display change: time from that change to the first servo write
+    if (!command_wake && clock_deadline_us_ != 0 && clock_deadline_us_ != CLOCK_NO_DEADLINE) {
+        wake_change_us_ = clock_deadline_us_;
+    }
+
     // Call timer tick logic
-    clock->OnTimerTick();
+    int64_t start_us = esp_timer_get_time();
+    OnTimerTick();
+    int64_t end_us = esp_timer_get_time();
+    wake_change_us_ = 0; // The display did not change
+    if (tick_monitor_.EndTick(end_us)) {
+        ESP_LOGW(TAG, "Clock tick overran: %lld ms", (long long)((end_us - start_us) / 1000));
+    }
+
+    // Sleep until the earliest deadline: the next minute for the clock, the next digit change
+    // for countdown and stopwatch, the sleep schedule, the telemetry save, never for static
+    // modes. Commands notify the task directly through PostCommand(); a notification that
+    // arrived during this tick is still pending and runs the next one right away.
+    int delay_ms = NextTickDelayMs(end_us);
+    if (delay_ms < 0) {
+        xTimerStop(clock_timer_, 0);
+        tick_monitor_.Unschedule();
+    } else {
+        xTimerChangePeriod(clock_timer_, std::max<TickType_t>(pdMS_TO_TICKS(delay_ms), 1), 0);
+        tick_monitor_.Reschedule(end_us, delay_ms);
+    }
+}
+
+// Milliseconds until the next tick should run, -1 if nothing changes until a command arrives
+int CyberClock::NextTickDelayMs(int64_t now_us) const {
+    if (clock_deadline_us_ == CLOCK_NO_DEADLINE) return -1;
+    int64_t delay_us = std::max<int64_t>(clock_deadline_us_ - now_us, 0);
+    return (int)((delay_us + 999) / 1000) + TICK_CHANGE_MARGIN_MS;
+}
+
+// Any task: queue a command for the clock task and wake it, false when the ring is full
+bool CyberClock::PostCommand(ClockCommand command) {
+    command.enqueue_us = esp_timer_get_time();
+    if (!commands_.Push(command)) {
+        command_latency_.Drop();
+        ESP_LOGE(TAG, "Command queue full, command %d dropped", command.type);
+        return false;
+    }
+    if (clock_task_ != nullptr) {
+        xTaskNotifyGive(clock_task_); // The clock may be asleep until its next deadline
+    }
+    return true;
+}
+
+// Clock task: apply every queued command in posting order, returns how many there were
+int CyberClock::DrainCommands() {
+    int drained = 0;
+    ClockCommand command;
+    while (commands_.Pop(command)) {
+        drained++;
+        command_latency_.Record(esp_timer_get_time() - command.enqueue_us);
+        const int32_t* args = command.args;
+        switch (command.type) {
+            case CLOCK_CMD_SET_NUMBER:
+            case CLOCK_CMD_SET_COUNTDOWN:
+            case CLOCK_CMD_SET_TIMER:
+            case CLOCK_CMD_SHOW_TIME:
+            case CLOCK_CMD_IDLE:
+            case CLOCK_CMD_SHUTDOWN:
+            case CLOCK_CMD_SET_TEXT:
+            case CLOCK_CMD_PREVIEW:
+            case CLOCK_CMD_BUTTON_CLICK:
+                command_coalescer_.Add(command.enqueue_us); // Changes what the modes show
+                break;
+            default:
+                break;
+        }
+        switch (command.type) {
+            case CLOCK_CMD_SET_NUMBER: ApplyNumber(args[0], args[1], args[2], args[3]); break;
+            case CLOCK_CMD_SET_COUNTDOWN: ApplyCountDown(args[0]); break;
+            case CLOCK_CMD_SET_TIMER: ApplyTimer(args[0]); break;
+            case CLOCK_CMD_SHOW_TIME: ApplyShowTime(); break;
+            case CLOCK_CMD_IDLE: ApplyIdleClock(); break;
+            case CLOCK_CMD_SHUTDOWN: ApplyShutdownClock(); break;
+            case CLOCK_CMD_SILENT_MODE: ApplyServoSilentMode(args[0] != 0); break;
+            case CLOCK_CMD_12_HOUR: Apply12HourMode(args[0] != 0); break;
+            case CLOCK_CMD_SLEEP_TIME: ApplySleepTime(args[0] != 0, args[1], args[2], args[3], args[4]); break;
+            case CLOCK_CMD_PLAY_ANIMATION: pending_animation_ = command.animation; break;
+            case CLOCK_CMD_HOURLY_ANIMATION: ApplyHourlyAnimation(command.animation); break;
+            case CLOCK_CMD_SELF_TEST: ApplyStartSelfTest(); break;
+            case CLOCK_CMD_TIME_CHANGED: break; // The tick reads the new time
+            case CLOCK_CMD_SET_TEXT: ApplyText(command.text); break;
+            case CLOCK_CMD_PREVIEW: ApplyPreview(args[0]); break;
+            case CLOCK_CMD_BUTTON_CLICK: ApplyButtonClick(); break;
+            case CLOCK_CMD_SPEED: ApplySpeed(args[0], args[1]); break;
+            case CLOCK_CMD_SET_OFFSETS: ApplyServoOffsets(command.offsets); break;
+        }
+    }
+    return drained;
+}
+
+void CyberClock::ShutdownClock() {
+    PostCommand({CLOCK_CMD_SHUTDOWN});
+}
+
+void CyberClock::IdleClock() {
+    PostCommand({CLOCK_CMD_IDLE});
+}
+
+void CyberClock::ShowTime() {
+    PostCommand({CLOCK_CMD_SHOW_TIME});
+}
+
+void CyberClock::SetNumber(int a, int b, int c, int d) {
+    PostCommand({CLOCK_CMD_SET_NUMBER, {a, b, c, d}});
+}
+
+bool CyberClock::SetText(const char* text) {
+    ClockCommand command = {CLOCK_CMD_SET_TEXT};
+    strncpy(command.text, text, sizeof(command.text) - 1); // Cut at TEXT_MAX_LEN
+    return PostCommand(command);
+}
+
+void CyberClock::SetCountDown(int seconds) {
+    PostCommand({CLOCK_CMD_SET_COUNTDOWN, {seconds}});
+}
+
+void CyberClock::SetTimer(int operation) {
+    PostCommand({CLOCK_CMD_SET_TIMER, {operation}});
+}
+
+void CyberClock::SetServoSilentMode(bool mode) {
+    PostCommand({CLOCK_CMD_SILENT_MODE, {mode}});
+}
+
+bool CyberClock::SetSpeed(const char* mode, const char* profile) {
+    int speed_mode = strcmp(mode, "night") == 0 ? SPEED_MODE_NUM : FindSpeedMode(mode);
+    int speed = FindSpeedProfile(profile);
+    if (speed_mode < 0 || (speed == SPEED_NONE && !(speed_mode == SPEED_MODE_NUM && strcmp(profile, "none") == 0))) {
+        ESP_LOGW(TAG, "Unknown speed setting: %s=%s", mode, profile);
+        return false;
+    }
+    return PostCommand({CLOCK_CMD_SPEED, {speed_mode, speed}});
+}
+
+void CyberClock::Set12HourMode(bool mode) {
+    PostCommand({CLOCK_CMD_12_HOUR, {mode}});
+}
+
+void CyberClock::SetSleepTime(bool mode, int start_hour, int start_minute, int end_hour, int end_minute) {
+    PostCommand({CLOCK_CMD_SLEEP_TIME, {mode, start_hour, start_minute, end_hour, end_minute}});
+}
+
+bool CyberClock::PlayAnimation(const char* name) {
+    const Animation* animation = FindAnimation(name);
+    if (animation == nullptr) {
+        ESP_LOGW(TAG, "Unknown animation: %s", name);
+        return false;
+    }
+    return PostCommand({CLOCK_CMD_PLAY_ANIMATION, {}, animation});
+}
+
+bool CyberClock::SetHourlyAnimation(const char* name) {
+    const Animation* animation = FindAnimation(name);
+    if (animation == nullptr && strcmp(name, "none") != 0) {
+        ESP_LOGW(TAG, "Unknown animation: %s", name);
+        return false;
+    }
+    return PostCommand({CLOCK_CMD_HOURLY_ANIMATION, {}, animation});
+}
+
+void CyberClock::TimeChanged() {
+    PostCommand({CLOCK_CMD_TIME_CHANGED});
+}
+
+void CyberClock::StartSelfTest() {
+    PostCommand({CLOCK_CMD_SELF_TEST});
+}
+
+void CyberClock::PreviewDisplay(int mode) {
+    PostCommand({CLOCK_CMD_PREVIEW, {mode}});
+}
+
+void CyberClock::ButtonClick() {
+    PostCommand({CLOCK_CMD_BUTTON_CLICK});
+}
+
+bool CyberClock::SetServoOffsets(const int* offsets) {
+    ClockCommand command = {CLOCK_CMD_SET_OFFSETS};
+    for (int i = 0; i < SERVO_CHANNEL_NUM; i++) {
+        command.offsets[i] = (int16_t)std::clamp(offsets[i], -SERVO_POSITION_MAX, SERVO_POSITION_MAX);
+    }
+    return PostCommand(command);
 }
 
-void CyberClock::AddServoTask(int ch, int start_position, int to_position, int front_channel , bool smooth ) {
+// Queue one planned move, false when it could not be queued
+bool CyberClock::AddServoTask(ServoState task) {
     // Validate channel range
-    if (ch < 0 || ch > 27) {
-        ESP_LOGE(TAG, "Invalid channel: %d", ch);
-        return;
+    if (task.channel < 0 || task.channel >= SERVO_CHANNEL_NUM) {
+        ESP_LOGE(TAG, "Invalid channel: %d", task.channel);
+        return false;
     }
 
     // Validate position range
-    if (start_position < 100 || start_position > 550 || to_position < 100 || to_position > 550) {
-        ESP_LOGE(TAG, "Invalid position at channel %d: start_position=%d, to_position=%d", ch, start_position, to_position);
-        start_position = std::clamp(start_position, 100, 550);
-        to_position = std::clamp(to_position, 100, 550);
+    if (task.current_position < 100 || task.current_position > 550 || task.target_position < 100 || task.target_position > 550) {
+        ESP_LOGE(TAG, "Invalid position at channel %d: start_position=%d, to_position=%d", task.channel, task.current_position, task.target_position);
+        task.current_position = std::clamp(task.current_position, 100, 550);
+        task.target_position = std::clamp(task.target_position, 100, 550);
     }
 
-    // Create task
-    ServoState task = {ch, start_position, to_position, front_channel, -1, smooth};
-
     // Lock task array
+    bool added = false;
     if (xSemaphoreTake(task_queue_mutex_, pdMS_TO_TICKS(100)) == pdTRUE) {
-        // Add task to array
-        servo_states_.push_back(task);
-        ESP_LOGI(TAG, "AddTask: channel=%d, start_pos=%d, to_pos=%d, front_ch=%d, smooth=%d",
-                 ch, start_position, to_position, front_channel, smooth);
+        // Start the move as a script, it waits for its front channels by itself
+        added = motion_engine_.AddTask(task);
+        if (added) {
+            telemetry_.RecordMove(task.channel);
+            trace_.RecordPlan(TraceTimeMs(), task);
+        } else {
+            ESP_LOGE(TAG, "No free motion script for channel %d", task.channel);
+        }
+        ESP_LOGI(TAG, "AddTask: channel=%d, start_pos=%d, to_pos=%d, front_ch=%d/%d, step=%d",
+                 task.channel, task.current_position, task.target_position,
+                 task.front_channels[0], task.front_channels[1], task.step);
 
         // Unlock
         xSemaphoreGive(task_queue_mutex_);
     } else {
         ESP_LOGE(TAG, "Failed to acquire task queue mutex");
     }
+    return added;
 }
 
-void CyberClock::TaskUpdateDisplay(int a, int b, int c, int d, bool smooth) {
-    if (!servo_driver_available_) return;
+CyberClock::DisplayGlyphs CyberClock::UniformGlyphs(int glyph) {
+    DisplayGlyphs glyphs;
+    std::fill(glyphs.glyph, glyphs.glyph + CLOCK_DIGIT_NUM, glyph);
+    return glyphs;
+}
 
-    // Acquire semaphore
-    if (xSemaphoreTake(display_mutex_, portMAX_DELAY) == pdTRUE) {
-        //ESP_LOGW(TAG, "== Task UpdateDisplay ==  %d %d : %d %d smooth=%d", a, b, c, d, smooth);
-
-        // Get target positions
-        GetTargetPosition(a, b, c, d);
-
-        int midOffset;
-        if(Servo_Mode_ == 0) midOffset = 120; 
-        if(Servo_Mode_ == 1) midOffset = 50; // New version: smaller avoidance distance
-
-        auto ProcessDigit = [&](int digit, int base_channel) {
-            //ESP_LOGI(TAG, "Processing digit %d at base_channel %d", digit, base_channel);
-
-            int middle_channel = base_channel + 6; // Middle pointer channel
-            int adjCh1 = base_channel + 1;         // Adjacent pointer channel 1
-            int adjCh5 = base_channel + 5;         // Adjacent pointer channel 5
-
-            // Record avoidance positions for 1 and 5
-            int adjCh1_position = 0;
-            int adjCh5_position = 0;
-            int front_channel = -1;
-
-            //if(Servo_Mode_ == 0) // Old version needs avoidance
-            {
-                // Check if middle pointer needs avoidance
-                if (abs(clock_current_position_[middle_channel] - clock_target_position_[middle_channel]) > 100) {
-                    // If middle pointer is at SegmentOn, check adjacent pointers
-                    if (clock_current_position_[adjCh1] == segmentOn[adjCh1] + servo_offsets_[adjCh1]) {
-                        adjCh1_position = segmentOn[adjCh1] + midOffset + servo_offsets_[adjCh1];
-                        front_channel = adjCh1; // If adjCh1 moves, set as dependency
-                        AddServoTask(adjCh1, clock_current_position_[adjCh1], adjCh1_position, -1,smooth);
-                    }
-                    if (clock_current_position_[adjCh5] == segmentOn[adjCh5] + servo_offsets_[adjCh5]) {
-                        adjCh5_position = segmentOn[adjCh5] - midOffset + servo_offsets_[adjCh5];
-                        front_channel = adjCh5; // If adjCh5 moves, set as dependency
-                        AddServoTask(adjCh5, clock_current_position_[adjCh5], adjCh5_position,-1, smooth);
-                    }
-                }
-            }
+CyberClock::DisplayGlyphs CyberClock::DigitGlyphs(int a, int b, int c, int d) {
+    DisplayGlyphs glyphs = UniformGlyphs(GLYPH_OFF);
+    glyphs.glyph[0] = a;
+    glyphs.glyph[1] = b;
+    glyphs.glyph[2] = c;
+    glyphs.glyph[3] = d;
+    return glyphs;
+}
 
-            // Move middle pointer to target position
-            if (clock_current_position_[middle_channel] != clock_target_position_[middle_channel]) {
-                AddServoTask(middle_channel, clock_current_position_[middle_channel], clock_target_position_[middle_channel], front_channel,smooth);
-            }
+// Mode logic: publish the frame the display should show, motion picks it up in ApplyDisplayFrame
+void CyberClock::TaskUpdateDisplay(const DisplayGlyphs& glyphs, int speed) {
+    DisplayFrame& frame = display_frames_.Back();
+    std::copy(glyphs.glyph, glyphs.glyph + CLOCK_DIGIT_NUM, frame.glyph);
+    frame.speed = speed;
+    display_frames_.Publish();
+}
 
-            // Process other pointers
-            for (int i = 0; i < 7; i++) {
-                if (i == 6) continue; // Skip middle pointer
-
-                if (i == 1 && adjCh1_position != 0) {
-                    // For 1, move from avoidance to target
-                    AddServoTask(adjCh1, adjCh1_position,
-                                 digits[digit][1] ? segmentOn[adjCh1] + servo_offsets_[adjCh1] : segmentOff[adjCh1] + servo_offsets_[adjCh1], middle_channel, smooth);
-                } else if (i == 5 && adjCh5_position != 0) {
-                    // For 5, move from avoidance to target
-                    AddServoTask(adjCh5, adjCh5_position,
-                                 digits[digit][5] ? segmentOn[adjCh5] + servo_offsets_[adjCh5] : segmentOff[adjCh5] + servo_offsets_[adjCh5], middle_channel, smooth);
-                } else if (clock_current_position_[base_channel + i] != clock_target_position_[base_channel + i]) {
-                    // For others, move from current to target
-                    AddServoTask(base_channel + i, clock_current_position_[base_channel + i], clock_target_position_[base_channel + i],-1, smooth);
-                }
+// Motion: plan the moves to the latest published frame. Returns their modelled time in ms,
+// 0 when nothing new was published, -1 when none of its moves could be queued and the frame
+// has to be planned again (the next tick does that).
+int CyberClock::ApplyDisplayFrame() {
+    DisplayFrame frame;
+    if (!display_frames_.TakeLatest(frame) || !servo_driver_available_) return 0;
+
+    // Plan moves from the current positions, avoidance included
+    std::vector<ServoState> plan;
+    int target[SERVO_CHANNEL_NUM];
+    PlanDisplayTransition(kServoProfiles[Servo_Mode_], servos_.offset, servos_.position,
+                          frame.glyph, kSpeedProfiles[frame.speed].step, target, plan);
+    OptimizeMoveOrder(plan);
+
+    // Model before queueing: the estimate runs its own engine on the clock's frame pool,
+    // next to the queued moves it would need room for the plan twice
+    int modelled_ms = EstimatePlanTimeMs(plan);
+    if (modelled_ms < 0 || MotionPoolFree(MOTION_POOL_CLOCK) < (int)plan.size()) {
+        ESP_LOGE(TAG, "No motion script frames for %d moves, frame planned again", (int)plan.size());
+        display_frames_.Retake();
+        return -1;
+    }
+    for (const auto& task : plan) {
+        if (!AddServoTask(task)) {
+            // Moves behind a dropped one would find no move to wait for on its channel and
+            // start early, so none of the plan runs; the next tick plans the frame again
+            ESP_LOGE(TAG, "Move on channel %d dropped, plan of %d moves aborted", task.channel, (int)plan.size());
+            if (xSemaphoreTake(task_queue_mutex_, pdMS_TO_TICKS(100)) == pdTRUE) {
+                motion_engine_.Clear();
+                xSemaphoreGive(task_queue_mutex_);
+            } else {
+                ESP_LOGE(TAG, "Failed to acquire task queue mutex");
             }
-        };
-
-        // Process a/b/c/d digits
-        ProcessDigit(a, 0);  // Hour tens
-        ProcessDigit(b, 7);  // Hour units
-        ProcessDigit(c, 14); // Minute tens
-        ProcessDigit(d, 21); // Minute units
-
-        // Release semaphore
-        xSemaphoreGive(display_mutex_);
-    } else {
-        ESP_LOGW(TAG, "Failed to acquire display mutex");
+            display_frames_.Retake();
+            return -1;
+        }
     }
+    std::copy(target, target + SERVO_CHANNEL_NUM, servos_.target);
+    std::copy(servos_.target, servos_.target + SERVO_CHANNEL_NUM, live_state_.target);
+    PublishState();
+    applied_speed_ = frame.speed;
+    return modelled_ms;
 }
 
-void CyberClock::ShutdownClock() {
+// Clock task: make live_state_ visible to other tasks
+void CyberClock::PublishState() {
+    live_state_.mode = current_mode_;
+    live_state_.owner = display_arbiter_.Owner();
+    live_state_.moves_active = motion_engine_.MovesActive();
+    live_state_.scripts_alive = motion_engine_.ScriptsAlive();
+    live_state_.published_ms = TraceTimeMs();
+    state_snapshot_.Write(live_state_);
+}
+
+void CyberClock::ApplyShutdownClock() {
     if (!servo_driver_available_) return;
 
     ESP_LOGW(TAG, "*** SHUT DOWN CLOCK ***");
-    current_mode_ = MODE_99_SHUTDOWN;
+    display_arbiter_.Claim(DISPLAY_SOURCE_WEB, MODE_99_SHUTDOWN);
 }
 
 void CyberClock::UpdateIdleClock() {
     if (!servo_driver_available_) return;
 
     ESP_LOGW(TAG, "*** IDLE CLOCK ***");
-    current_mode_ = MODE_03_IDLE;
+    display_arbiter_.Claim(DISPLAY_SOURCE_SCHEDULE, MODE_03_IDLE);
 }
 
-void CyberClock::SetCountDown(int seconds)
+void CyberClock::ApplyCountDown(int seconds)
 {
-    // Set countdown
-    countdown_time_ = seconds;
-    current_mode_ = MODE_02_SET_COUNTDOWN;
+    // Set countdown, up to 99:59 hours. It holds the display until it has finished.
+    int64_t now_us = esp_timer_get_time();
+    countdown_.StartCountdown(now_us, seconds);
+    int64_t end_us = now_us + (int64_t)(countdown_.Seconds(now_us) + DISPLAY_COUNTDOWN_LINGER_S) * 1000000;
+    display_arbiter_.Claim(DISPLAY_SOURCE_TIMER, MODE_02_SET_COUNTDOWN, end_us);
     ESP_LOGI(TAG, "Countdown started: %d minutes, %d seconds", seconds / 60, seconds % 60);
 }
 
-void CyberClock::SetTimer(int operation)
+void CyberClock::ApplyTimer(int operation)
 {
     // Reset timer
     if (operation == 0) { // 0 means cancel timer
-        a_number_ = 0;
-        b_number_ = 0;
-        c_number_ = 0;
-        d_number_ = 0;
-        current_mode_ = MODE_01_SET_NUMBER;   
-        timer_tick_ = 0; // Reset timer
+        stopwatch_.Reset(); // Reset timer, shows 00:00
+        display_arbiter_.Claim(DISPLAY_SOURCE_TIMER, MODE_04_SET_TIMER);
         ESP_LOGW(TAG, "Timer reset to 00:00");
         return;
     }
     
     // Start timer
     if (operation == 1) {
-        current_mode_ = MODE_04_SET_TIMER;
+        stopwatch_.StartStopwatch(esp_timer_get_time());
+        display_arbiter_.Claim(DISPLAY_SOURCE_TIMER, MODE_04_SET_TIMER);
         ESP_LOGW(TAG, "Timer started");
         return;
     }
 
     // Stop timer
     if (operation == 2) {
-        int minutes = timer_tick_ / 60;
-        int seconds = timer_tick_ % 60;
-        a_number_ = minutes / 10;
-        b_number_ = minutes % 10;
-        c_number_ = seconds / 10;
-        d_number_ = seconds % 10;
-        current_mode_ = MODE_01_SET_NUMBER; // Stop timer, return to normal clock
+        stopwatch_.Stop(esp_timer_get_time()); // The stopped value stays on the display
+        display_arbiter_.Claim(DISPLAY_SOURCE_TIMER, MODE_04_SET_TIMER);
         ESP_LOGW(TAG, "Timer stopped");
         return;
     }
 }
 
-void CyberClock::SetNumber(int a,int b,int c,int d)
+// Countdown and stopwatch value, MM:SS up to 99:59 and HH:MM above
+CyberClock::DisplayGlyphs CyberClock::DurationGlyphs(int seconds) {
+    int digits[4];
+    DurationDigits(seconds, digits);
+    ESP_LOGI(TAG, "%s: %d%d:%d%d", current_mode_ == MODE_02_SET_COUNTDOWN ? "Countdown" : "Timer",
+             digits[0], digits[1], digits[2], digits[3]);
+    return DigitGlyphs(digits[0], digits[1], digits[2], digits[3]);
+}
+
+void CyberClock::ApplyNumber(int a,int b,int c,int d)
 {
     a_number_ = a;
     b_number_ = b;
     c_number_ = c;
     d_number_ = d;
-    current_mode_ = MODE_01_SET_NUMBER;   
+    display_arbiter_.Claim(DISPLAY_SOURCE_WEB, MODE_01_SET_NUMBER);
     ESP_LOGI(TAG, "SetNumber: %d%d:%d%d", a_number_, b_number_, c_number_, d_number_);         
 }
 
-void CyberClock::SetServoSilentMode(bool mode)
+void CyberClock::ApplyText(const char* text)
+{
+    text_display_.SetText(text, esp_timer_get_time());
+    display_arbiter_.Claim(DISPLAY_SOURCE_WEB, MODE_05_TEXT);
+    ESP_LOGI(TAG, "SetText: \"%s\"%s", text_display_.Text(), text_display_.Scrolling() ? ", scrolling" : "");
+}
+
+void CyberClock::ApplyServoSilentMode(bool mode)
 {
-    // Control mute mode
+    // Control mute mode: the clock's speed profile, silent or fast
     if (mode) {
         ESP_LOGI(TAG, "Enabling mute mode");
-        servo_mute_mode_ = true;
     } else {
         ESP_LOGI(TAG, "Disabling mute mode");
-        servo_mute_mode_ = false;
     }
     Settings settings("cyberclock",true);
-    settings.SetInt("servo_mute_en", servo_mute_mode_);
+    settings.SetInt("servo_mute_en", mode);
     ESP_LOGI(TAG, "Save to settings mute mode");
+    ApplySpeed(SPEED_MODE_CLOCK, mode ? SPEED_SILENT : SPEED_FAST);
+}
+
+// Calibration from the web page: new offsets for every servo, saved as adjust_data
+void CyberClock::ApplyServoOffsets(const int16_t* offsets)
+{
+    char adjust_data[SERVO_CHANNEL_NUM * 8] = {0}; // 每个整数连同分隔符不超过 8 字节
+    int length = 0;
+    for (int i = 0; i < SERVO_CHANNEL_NUM; i++) {
+        servos_.offset[i] = offsets[i];
+        live_state_.offset[i] = offsets[i];
+        length += snprintf(adjust_data + length, sizeof(adjust_data) - length, "%d|", offsets[i]);
+    }
+    adjust_data[length - 1] = '\0'; // 移除最后一个多余的分隔符
+    PublishState();
+
+    // Whatever mode is showing, move to the frame on display with the new offsets this tick
+    display_frames_.Retake();
+
+    Settings settings("cyberclock",true);
+    settings.SetString("adjust_data", adjust_data);
+    ESP_LOGI(TAG, "Saved adjust_data: %s", adjust_data);
+}
+
+// speed_mode SPEED_MODE_NUM sets the night override, profile SPEED_NONE clears it
+void CyberClock::ApplySpeed(int speed_mode, int profile)
+{
+    Settings settings("cyberclock",true);
+    if (speed_mode == SPEED_MODE_NUM) {
+        night_speed_ = profile;
+        settings.SetInt("speed_night", night_speed_);
+        ESP_LOGI(TAG, "Night speed: %s", night_speed_ == SPEED_NONE ? "none" : kSpeedProfiles[night_speed_].name);
+        return;
+    }
+    mode_speed_[speed_mode] = profile;
+    char key[16];
+    snprintf(key, sizeof(key), "speed_%s", SpeedModeName(speed_mode));
+    settings.SetInt(key, profile);
+    ESP_LOGI(TAG, "Speed of %s: %s", SpeedModeName(speed_mode), kSpeedProfiles[profile].name);
+}
+
+// Profile for a transition of speed_mode now; the night override wins inside the sleep window
+int CyberClock::ModeSpeed(int speed_mode) const
+{
+    if (night_speed_ != SPEED_NONE && InSleepWindow()) return night_speed_;
+    return mode_speed_[speed_mode];
+}
+
+// Local time between the sleep start and end, whether or not the nightly idle is enabled
+bool CyberClock::InSleepWindow() const
+{
+    time_t now = time(nullptr);
+    struct tm* timeinfo = localtime(&now);
+    int now_min = timeinfo->tm_hour * 60 + timeinfo->tm_min;
+    int start_min = sleep_start_hour_ * 60 + sleep_start_minute_;
+    int end_min = sleep_end_hour_ * 60 + sleep_end_minute_;
+    if (start_min <= end_min) return now_min >= start_min && now_min < end_min;
+    return now_min >= start_min || now_min < end_min; // Across midnight
 }
 
-void CyberClock::ShowTime()
+void CyberClock::ApplyShowTime()
 {
-    // Restore to MODE_00_NORMAL_CLOCK
-    current_mode_ = MODE_00_NORMAL_CLOCK;
+    // Drop every claim but a running self test; the schedule idles again at the next sleep start
+    display_arbiter_.ReleaseRange(DISPLAY_SOURCE_PAGE, DISPLAY_SOURCE_BUTTON);
+    display_arbiter_.Claim(DISPLAY_SOURCE_SCHEDULE, MODE_00_NORMAL_CLOCK);
     ESP_LOGI(TAG, "ShowTime: Restored to normal clock mode");
 }
 
-void CyberClock::SetSleepTime(bool mode, int start_hour, int start_minute, int end_hour, int end_minute)
+void CyberClock::ApplySleepTime(bool mode, int start_hour, int start_minute, int end_hour, int end_minute)
 {
     // Set sleep time
     sleep_clock_enable_ = mode;
@@ -400,6 +680,10 @@ void CyberClock::SetSleepTime(bool mode, int start_hour, int start_minute, int e
     sleep_end_hour_ = end_hour;
     sleep_end_minute_ = end_minute;
 
+    if (!sleep_clock_enable_) {
+        display_arbiter_.Claim(DISPLAY_SOURCE_SCHEDULE, MODE_00_NORMAL_CLOCK); // Leave a nightly idle
+    }
+
     Settings settings("cyberclock",true);
     settings.SetInt("sleep_clock_en", sleep_clock_enable_);
     settings.SetInt("sleep_s_hour", sleep_start_hour_);
@@ -413,14 +697,151 @@ void CyberClock::SetSleepTime(bool mode, int start_hour, int start_minute, int e
 }
 
 
+// Handlers for every mode that drives the display; other modes leave it as it is
+const CyberClock::ModeEntry CyberClock::kModeHandlers[] = {
+    {MODE_99_SHUTDOWN, &CyberClock::ShutdownFrame, SPEED_MODE_IDLE},
+    {MODE_03_IDLE, &CyberClock::IdleFrame, SPEED_MODE_IDLE},
+    {MODE_01_SET_NUMBER, &CyberClock::NumberFrame, SPEED_MODE_NUMBER},
+    {MODE_02_SET_COUNTDOWN, &CyberClock::CountdownFrame, SPEED_MODE_COUNTDOWN},
+    {MODE_04_SET_TIMER, &CyberClock::StopwatchFrame, SPEED_MODE_TIMER},
+    {MODE_05_TEXT, &CyberClock::TextFrame, SPEED_MODE_TEXT},
+    {MODE_00_NORMAL_CLOCK, &CyberClock::NormalClockFrame, SPEED_MODE_CLOCK},
+    {MODE_100_TEST, &CyberClock::SelfTestFrame, SPEED_MODE_CLOCK}, // Picks its own steps
+    {MODE_98_ADJUST, &CyberClock::AdjustFrame, SPEED_MODE_NUMBER},
+};
+
+CyberClock::ModeFrame CyberClock::ShutdownFrame(int64_t now_us) {
+    return {true, UniformGlyphs(GLYPH_OFF), CLOCK_NO_DEADLINE}; // Show all off
+}
+
+CyberClock::ModeFrame CyberClock::IdleFrame(int64_t now_us) {
+    return {true, UniformGlyphs(GLYPH_IDLE), CLOCK_NO_DEADLINE}; // Show idle
+}
+
+CyberClock::ModeFrame CyberClock::NumberFrame(int64_t now_us) {
+    return {true, DigitGlyphs(a_number_, b_number_, c_number_, d_number_), CLOCK_NO_DEADLINE};
+}
+
+// The value comes from the start timestamp, late ticks skip ahead
+CyberClock::ModeFrame CyberClock::CountdownFrame(int64_t now_us) {
+    if (!countdown_.Running()) {
+        return {false, {}, CLOCK_NO_DEADLINE};
+    }
+    int seconds = countdown_.Seconds(now_us);
+    ModeFrame frame = {true, DurationGlyphs(seconds), CLOCK_NO_DEADLINE};
+    if (seconds == 0) {
+        countdown_.Stop(now_us); // 00:00 stays on the display
+        ESP_LOGI(TAG, "Countdown finished");
+    } else {
+        frame.next_change_us = now_us + countdown_.NextChangeUs(now_us);
+    }
+    return frame;
+}
+
+CyberClock::ModeFrame CyberClock::StopwatchFrame(int64_t now_us) {
+    ModeFrame frame = {true, DurationGlyphs(stopwatch_.Seconds(now_us)), CLOCK_NO_DEADLINE};
+    int64_t next_us = stopwatch_.NextChangeUs(now_us);
+    if (next_us >= 0) {
+        frame.next_change_us = now_us + next_us;
+    }
+    return frame;
+}
+
+// Scroll position from the start timestamp, late ticks skip ahead
+CyberClock::ModeFrame CyberClock::TextFrame(int64_t now_us) {
+    ModeFrame frame = {true, {}, CLOCK_NO_DEADLINE};
+    std::copy_n(text_display_.Glyphs(now_us), CLOCK_DIGIT_NUM, frame.glyphs.glyph);
+    int64_t next_us = text_display_.NextChangeUs(now_us);
+    if (next_us >= 0) {
+        frame.next_change_us = now_us + next_us;
+    }
+    return frame;
+}
+
+// HH:MM changes on the minute (HH:MM:SS on the second); before SNTP has set the time
+// nothing changes until SyncTime() calls TimeChanged()
+CyberClock::ModeFrame CyberClock::NormalClockFrame(int64_t now_us) {
+    static int last_hour = -1;
+    static int last_minute = -1;
+    ModeFrame frame = {false, {}, CLOCK_NO_DEADLINE};
+    if (xSemaphoreTake(server_time_ready_semaphore, 0) != pdTRUE) {
+        return frame;
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    struct tm* timeinfo = localtime(&tv.tv_sec); // localtime includes timezone and minute offset
+    int current_hour = timeinfo->tm_hour;
+    int current_minute = timeinfo->tm_min;
+    int display_hour = current_hour;
+    if(clock_12_hour_) {
+        // 12 hour mode
+        // Convert to 12-hour format
+        // If display_hour > 12, subtract 12; if display_hour == 0, set to 12
+        // This is only for display purposes, not for internal logic
+        if (display_hour > 12) {
+            display_hour -= 12; 
+        } else if (display_hour == 0) {
+            display_hour = 12; 
+        }
+    }
+    // Check if the current time is different from the last displayed time
+    if (display_hour != last_hour || current_minute != last_minute) {
+        ESP_LOGI(TAG, "Time changed: %02d:%02d -> %02d:%02d", last_hour, last_minute, display_hour, current_minute);
+        // Hourly flourish, not on the first display after boot
+        if (current_minute == 0 && last_minute != -1 && hourly_animation_ != nullptr) {
+            RunAnimation(*hourly_animation_);
+        }
+        last_hour = display_hour;
+        last_minute = current_minute;
+    }
+    // Regardless of whether it changes, show the current time
+    frame.show = true;
+    frame.glyphs = DigitGlyphs(display_hour / 10, display_hour % 10,
+                               current_minute / 10, current_minute % 10);
+#if CLOCK_DIGIT_NUM >= 6
+    frame.glyphs.glyph[4] = timeinfo->tm_sec / 10; // HH:MM:SS
+    frame.glyphs.glyph[5] = timeinfo->tm_sec % 10;
+    frame.next_change_us = now_us + 1000000 - tv.tv_usec;
+#else
+    frame.next_change_us = now_us + (int64_t)(60 - timeinfo->tm_sec) * 1000000 - tv.tv_usec;
+#endif
+    xSemaphoreGive(server_time_ready_semaphore);
+    return frame;
+}
+
+// Self-benchmark, one step per second; it moves the servos itself
+CyberClock::ModeFrame CyberClock::SelfTestFrame(int64_t now_us) {
+    RunSelfTestStep();
+    return {false, {}, esp_timer_get_time() + (int64_t)TICK_PERIOD_MS * 1000};
+}
+
+// Calibration page: every segment lit
+CyberClock::ModeFrame CyberClock::AdjustFrame(int64_t now_us) {
+    return {true, UniformGlyphs(8), CLOCK_NO_DEADLINE};
+}
+
+// Next sleep start (or end while idle) of the nightly schedule, CLOCK_NO_DEADLINE if it is off
+int64_t CyberClock::NextSleepEventUs(int64_t now_us) const {
+    if (!sleep_clock_enable_) return CLOCK_NO_DEADLINE;
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    struct tm* timeinfo = localtime(&tv.tv_sec);
+    int now_sec = timeinfo->tm_hour * 3600 + timeinfo->tm_min * 60 + timeinfo->tm_sec;
+    bool idle = display_arbiter_.ClaimedMode(DISPLAY_SOURCE_SCHEDULE) == MODE_03_IDLE;
+    int event_sec = idle ? sleep_end_hour_ * 3600 + sleep_end_minute_ * 60
+                                                  : sleep_start_hour_ * 3600 + sleep_start_minute_ * 60;
+    int wait_sec = event_sec - now_sec;
+    if (wait_sec <= 0) wait_sec += 24 * 3600;
+    return now_us + (int64_t)wait_sec * 1000000 - tv.tv_usec;
+}
+
 void CyberClock::OnTimerTick() {
 
     // TimerCallback or OnTimerTick
     time_t now = time(nullptr);
     struct tm* timeinfo = localtime(&now); // localtime includes timezone and minute offset
     int now_sec = timeinfo->tm_hour * 3600 + timeinfo->tm_min * 60 + timeinfo->tm_sec;
-    int current_hour = timeinfo->tm_hour;
-    int current_minute = timeinfo->tm_min;
 
     // Check if alarm time is set
     if (alarm_time_ != -1 && now_sec / 60 == alarm_time_ / 60) {
@@ -430,96 +851,159 @@ void CyberClock::OnTimerTick() {
 
     // Check if in sleep time
     CheckSleepTime();
+    Arbitrate(esp_timer_get_time());
 
-    // Priority: shutdown > idle > set number > countdown > normal clock
+    // Animation requested from the web page, the mode below restores the display afterwards
+    const Animation* animation = pending_animation_;
+    if (animation != nullptr) {
+        pending_animation_ = nullptr;
+        RunAnimation(*animation);
+    }
 
-    // 1. shutdown mode
-    if(current_mode_ == MODE_99_SHUTDOWN) {
-        TaskUpdateDisplay(0xA, 0xA, 0xA, 0xA); // Show all off
+    // Current mode: the frame it wants and when that frame changes next. During a burst of
+    // display commands the frame waits until the burst pauses.
+    int64_t now_us = esp_timer_get_time();
+    ModeFrame frame = {false, {}, CLOCK_NO_DEADLINE};
+    int speed = SPEED_FAST;
+    int64_t release_us = command_coalescer_.ReleaseUs();
+    if (release_us > now_us) {
+        frame.next_change_us = release_us;
+    } else {
+        for (const ModeEntry& entry : kModeHandlers) {
+            if (entry.mode == current_mode_) {
+                frame = (this->*entry.handler)(now_us);
+                speed = ModeSpeed(entry.speed_mode);
+                break;
+            }
+        }
+        command_latency_.Coalesce(command_coalescer_.Flush());
+    }
+    if (frame.show) {
+        TaskUpdateDisplay(frame.glyphs, speed);
+    }
+
+    // Moves towards the latest frame the modes published, timed per speed profile
+    int64_t move_start_us = esp_timer_get_time();
+    int modelled_ms = ApplyDisplayFrame();
+    bool moving = !motion_engine_.Empty();
+    xSemaphoreGive(servo_mute_mode_semaphore_);
+    ExecuteTask();
+    if (moving && modelled_ms >= 0) {
+        speed_monitor_.Record(applied_speed_, esp_timer_get_time() - move_start_us, modelled_ms);
     }
+    PublishState(); // Mode changes without moves
+    telemetry_.Publish();
+    SaveTelemetry(false);
+
+    // The moves above may have made the telemetry dirty
+    int64_t end_us = esp_timer_get_time();
+    clock_deadline_us_ = std::min({frame.next_change_us, NextSleepEventUs(end_us), NextTelemetrySaveUs(end_us),
+                                   display_arbiter_.NextExpiryUs()});
+    if (modelled_ms < 0) {
+        // Frame put back. A shortage of script frames may last, so back off instead of
+        // planning it again right away in a busy loop.
+        tick_monitor_.PlanRetry();
+        clock_deadline_us_ = std::min<int64_t>(clock_deadline_us_, end_us + (int64_t)PLAN_RETRY_MS * 1000);
+    }
+}
 
-    // 2. idle mode
-    if(current_mode_ == MODE_03_IDLE) {
-        TaskUpdateDisplay(0xB, 0xB, 0xB, 0xB); // Show idle
+void CyberClock::ApplyStartSelfTest() {
+    display_arbiter_.Claim(DISPLAY_SOURCE_TEST, MODE_100_TEST);
+    ESP_LOGW(TAG, "Self test requested");
+}
+
+// A page load shows what the page adjusts, below anything a user or timer asked for
+void CyberClock::ApplyPreview(int mode) {
+    if (mode != MODE_98_ADJUST && mode != MODE_04_SET_TIMER) return;
+    if (mode == MODE_04_SET_TIMER && !display_arbiter_.Held(DISPLAY_SOURCE_TIMER)) {
+        stopwatch_.Reset(); // The timer page starts from 00:00 unless it is in use
     }
+    display_arbiter_.Claim(DISPLAY_SOURCE_PAGE, mode, esp_timer_get_time() + (int64_t)DISPLAY_PAGE_LEASE_S * 1000000);
+}
 
-    // 3. set number mode
-    if(current_mode_ == MODE_01_SET_NUMBER) {
-        TaskUpdateDisplay(a_number_, b_number_,c_number_, d_number_);
+// K1 shuts the display down over every other source, the next click hands it back
+void CyberClock::ApplyButtonClick() {
+    if (display_arbiter_.Held(DISPLAY_SOURCE_BUTTON)) {
+        ESP_LOGI(TAG, "K1 Click, display released");
+        display_arbiter_.Release(DISPLAY_SOURCE_BUTTON);
+    } else {
+        ESP_LOGI(TAG, "K1 Click, clock is shutting down...");
+        display_arbiter_.Claim(DISPLAY_SOURCE_BUTTON, MODE_99_SHUTDOWN);
     }
+}
 
-    // 4. countdown mode
-    if (current_mode_ == MODE_02_SET_COUNTDOWN) {
-        if (countdown_time_ >= 0) {
-            int minutes = countdown_time_ / 60;
-            int seconds = countdown_time_ % 60;
-            TaskUpdateDisplay(minutes / 10, minutes % 10, seconds / 10, seconds % 10);
-            countdown_time_--;
-            ESP_LOGI(TAG, "Countdown: %02d:%02d", minutes, seconds);
-        } else {
-            ESP_LOGI(TAG, "Countdown finished");
-        }
+// Clock task, after the commands and the schedule: the owner's mode becomes current_mode_
+void CyberClock::Arbitrate(int64_t now_us) {
+    display_arbiter_.Expire(now_us);
+    int mode = display_arbiter_.Mode();
+    if (mode != current_mode_) {
+        ESP_LOGI(TAG, "Display: mode %d -> %d (%s)", current_mode_, mode, DisplaySourceName(display_arbiter_.Owner()));
+        current_mode_ = mode;
     }
+}
 
-    // 5. set timer mode
-    if (current_mode_ == MODE_04_SET_TIMER) {
-        if (timer_tick_ >= 0) {
-            timer_tick_++;
-            int minutes = timer_tick_ / 60;
-            int seconds = timer_tick_ % 60;
-            TaskUpdateDisplay(minutes / 10, minutes % 10, seconds / 10, seconds % 10);
-            ESP_LOGI(TAG, "Timer: %02d:%02d", minutes, seconds);
-        } else {
-            ESP_LOGI(TAG, "Timer finished");
-        }
+// Runs the next step of the self-benchmark; back to the previous mode after the last one
+void CyberClock::RunSelfTestStep() {
+    if (!self_test_.Running()) {
+        self_test_.Start(esp_timer_get_time());
+        ESP_LOGW(TAG, "Self test started");
     }
 
-    // 6. normal clock mode
-    if (current_mode_ == MODE_00_NORMAL_CLOCK) {
-        static int last_hour = -1;
-        static int last_minute = -1;
-        if (xSemaphoreTake(server_time_ready_semaphore, 0) == pdTRUE) {
-            int display_hour = current_hour;
-            if(clock_12_hour_) {
-                // 12 hour mode
-                // Convert to 12-hour format
-                // If display_hour > 12, subtract 12; if display_hour == 0, set to 12
-                // This is only for display purposes, not for internal logic
-                if (display_hour > 12) {
-                    display_hour -= 12; 
-                } else if (display_hour == 0) {
-                    display_hour = 12; 
+    switch (self_test_.Phase()) {
+        case SELFTEST_I2C:
+            // Rewrite every channel where it is, the servos do not move
+            for (int round = 0; round < SELFTEST_I2C_ROUNDS; round++) {
+                for (int channel = 0; channel < SERVO_CHANNEL_NUM; channel++) {
+                    SetChannelPWM(channel, servos_.position[channel]);
                 }
             }
-            // Check if the current time is different from the last displayed time
-            if (display_hour != last_hour || current_minute != last_minute) {
-                ESP_LOGI(TAG, "Time changed: %02d:%02d -> %02d:%02d", last_hour, last_minute, display_hour, current_minute);
-                last_hour = display_hour;
-                last_minute = current_minute;
+            self_test_.NextPhase(esp_timer_get_time());
+            break;
+
+        case SELFTEST_FAST:
+        case SELFTEST_SMOOTH: {
+            DisplayGlyphs glyphs;
+            SelfTestGlyphs(self_test_.Step(), glyphs.glyph);
+            int64_t start_us = esp_timer_get_time();
+            TaskUpdateDisplay(glyphs, self_test_.Phase() == SELFTEST_SMOOTH ? SPEED_SILENT : SPEED_FAST);
+            int modelled_ms = ApplyDisplayFrame();
+            xSemaphoreGive(servo_mute_mode_semaphore_);
+            ExecuteTask();
+            if (modelled_ms < 0) {
+                // Earlier moves held the frames, plan again now that they are done
+                modelled_ms = ApplyDisplayFrame();
+                xSemaphoreGive(servo_mute_mode_semaphore_);
+                ExecuteTask();
+            }
+            self_test_.RecordTransition(esp_timer_get_time() - start_us, std::max(modelled_ms, 0));
+            self_test_.NextStep();
+            if (self_test_.Step() == SELFTEST_STEP_NUM) {
+                self_test_.NextPhase(esp_timer_get_time());
             }
-            // Regardless of whether it changes, call TaskUpdateDisplay
-            TaskUpdateDisplay(display_hour / 10, display_hour % 10,
-                              current_minute / 10, current_minute % 10, servo_mute_mode_);
-            xSemaphoreGive(server_time_ready_semaphore);
-        } 
-    }
-
-    // 100. Test Mode
-    if (current_mode_ == MODE_100_TEST) {
-        static bool test_servo_state = false;
-        if(test_servo_state == false) {
-            TaskUpdateDisplay(8, 8, 8, 8);
-        }else {
-            TaskUpdateDisplay(0xA, 0xA, 0xA, 0xA);
+            break;
         }
-        test_servo_state = !test_servo_state; 
+
+        case SELFTEST_FRAMES:
+            RunAnimation(kAnimations[0]);
+            self_test_.NextPhase(esp_timer_get_time());
+            break;
     }
 
-    xSemaphoreGive(servo_mute_mode_semaphore_);
-    ExecuteTask();
+    if (self_test_.Done()) {
+        for (int phase = 0; phase < SELFTEST_PHASE_NUM; phase++) {
+            const SelfTestPhaseResult& result = self_test_.Result(phase);
+            ESP_LOGI(TAG, "Self test %s: %lld ms, busy %d%%, i2c %d us avg (%u), frame %d us avg, transition %d us avg",
+                     SelfTestPhaseName(phase), (long long)(result.wall_us / 1000), result.BusyPercent(),
+                     (int)result.i2c.MeanUs(), (unsigned)result.i2c.count, (int)result.frame.MeanUs(),
+                     (int)result.transition.MeanUs());
+        }
+        display_arbiter_.Release(DISPLAY_SOURCE_TEST);
+        current_mode_ = display_arbiter_.Mode();
+        ESP_LOGW(TAG, "Self test finished in %lld ms", (long long)(self_test_.TotalUs() / 1000));
+    }
 }
 
-void CyberClock::Set12HourMode(bool mode){
+void CyberClock::Apply12HourMode(bool mode){
     if (mode) {
         ESP_LOGI("CyberClock", "12-hour mode enabled");
     } else {
@@ -532,7 +1016,16 @@ void CyberClock::Set12HourMode(bool mode){
 
 void CyberClock::LoadSettings(){
     Settings settings("cyberclock",true);
-    servo_mute_mode_ = settings.GetInt("servo_mute_en", 0);
+    // Speed profiles; the clock falls back to the old mute switch
+    mode_speed_[SPEED_MODE_CLOCK] = settings.GetInt("servo_mute_en", 0) ? SPEED_SILENT : SPEED_FAST;
+    for (int speed_mode = 0; speed_mode < SPEED_MODE_NUM; speed_mode++) {
+        char key[16];
+        snprintf(key, sizeof(key), "speed_%s", SpeedModeName(speed_mode));
+        int profile = settings.GetInt(key, mode_speed_[speed_mode]);
+        if (profile >= 0 && profile < SPEED_PROFILE_NUM) mode_speed_[speed_mode] = profile;
+    }
+    night_speed_ = settings.GetInt("speed_night", SPEED_NONE);
+    if (night_speed_ < SPEED_NONE || night_speed_ >= SPEED_PROFILE_NUM) night_speed_ = SPEED_NONE;
     sleep_clock_enable_ = settings.GetInt("sleep_clock_en", 0);
     sleep_end_hour_ = settings.GetInt("sleep_e_hour",7);
     sleep_end_minute_ = settings.GetInt("sleep_e_minute",0);
@@ -540,19 +1033,52 @@ void CyberClock::LoadSettings(){
     sleep_start_minute_ = settings.GetInt("sleep_s_minute",0);
     timezone_offset_ = settings.GetInt("tz", 8); // read offset of hours 
     timezone_offset_minute_ = settings.GetInt("mtz", 0); // read offset of minutes 
+    hourly_animation_ = FindAnimation(settings.GetString("hourly_anim", "none").c_str());
 
-    ESP_LOGI(TAG, "Loaded settings: servo_mute_mode=%d, sleep_clock_enable=%d, sleep_start_time=%02d:%02d, sleep_end_time=%02d:%02d, tz=%d, mtz=%d",
-             servo_mute_mode_, sleep_clock_enable_, sleep_start_hour_, sleep_start_minute_, sleep_end_hour_, sleep_end_minute_, timezone_offset_, timezone_offset_minute_);  
+    ESP_LOGI(TAG, "Loaded settings: clock speed=%s, sleep_clock_enable=%d, sleep_start_time=%02d:%02d, sleep_end_time=%02d:%02d, tz=%d, mtz=%d",
+             kSpeedProfiles[mode_speed_[SPEED_MODE_CLOCK]].name, sleep_clock_enable_, sleep_start_hour_, sleep_start_minute_, sleep_end_hour_, sleep_end_minute_, timezone_offset_, timezone_offset_minute_);  
 }
 
 
+void CyberClock::LoadTelemetry() {
+    ServoTelemetryBlob blob;
+    Settings settings("cyberclock", false);
+    if (settings.GetBlob("telemetry", &blob, sizeof(blob)) && telemetry_.Load(blob)) {
+        ESP_LOGI(TAG, "Servo telemetry restored");
+    }
+    telemetry_.Publish();
+    telemetry_saved_tick_ = xTaskGetTickCount();
+}
+
+// One batched NVS write, at most every TELEMETRY_SAVE_INTERVAL_MIN unless forced
+void CyberClock::SaveTelemetry(bool force) {
+    if (!telemetry_.Dirty()) return;
+    TickType_t now = xTaskGetTickCount();
+    if (!force && now - telemetry_saved_tick_ < pdMS_TO_TICKS(TELEMETRY_SAVE_INTERVAL_MIN * 60 * 1000)) return;
+
+    ServoTelemetryBlob blob;
+    telemetry_.Snapshot(blob);
+    Settings settings("cyberclock", true);
+    settings.SetBlob("telemetry", &blob, sizeof(blob));
+    telemetry_.MarkSaved();
+    telemetry_saved_tick_ = now;
+    ESP_LOGI(TAG, "Servo telemetry saved (%u bytes)", (unsigned)sizeof(blob));
+}
+
+// When SaveTelemetry() will write the dirty counters, CLOCK_NO_DEADLINE if they are clean
+int64_t CyberClock::NextTelemetrySaveUs(int64_t now_us) const {
+    if (!telemetry_.Dirty()) return CLOCK_NO_DEADLINE;
+    int64_t saved_ms = (int64_t)(xTaskGetTickCount() - telemetry_saved_tick_) * portTICK_PERIOD_MS;
+    int64_t wait_ms = std::max<int64_t>((int64_t)TELEMETRY_SAVE_INTERVAL_MIN * 60 * 1000 - saved_ms, 0);
+    return now_us + wait_ms * 1000;
+}
+
+int CyberClock::GetTelemetryAgeSeconds() const {
+    return (xTaskGetTickCount() - telemetry_saved_tick_) * portTICK_PERIOD_MS / 1000;
+}
+
 void CyberClock::InitialMutexAndSemaphore()
 {
-    display_mutex_ = xSemaphoreCreateMutex();
-    if (display_mutex_ == nullptr) {
-        ESP_LOGE(TAG, "Failed to create display mutex");
-    }      
-
     task_queue_mutex_ = xSemaphoreCreateMutex();
     if (task_queue_mutex_ == nullptr) {
         ESP_LOGE(TAG, "Failed to create task queue mutex");
@@ -568,10 +1094,6 @@ void CyberClock::InitialMutexAndSemaphore()
         ESP_LOGE(TAG, "Failed to create servo mute mode semaphore");
     }
 
-    servo_task_queue_ = xQueueCreate(50, sizeof(ServoState)); 
-    if (servo_task_queue_ == nullptr) {
-        ESP_LOGE(TAG, "Failed to create servo task queue");
-    }
 }
 
 void CyberClock::DetectServoMode()
@@ -583,17 +1105,8 @@ void CyberClock::DetectServoMode()
     Servo_Mode_ = !gpio_get_level(GPIO_NUM_1); // Read the level state of GPIO 1
     ESP_LOGI(TAG, "Servo_Mode_ = %d", Servo_Mode_);
     
-    if (Servo_Mode_ == 1) {
-        // High level, copy B array
-        ESP_LOGW(TAG, "Servo mode detected: B");
-        memcpy(segmentOn, segmentOn_B, sizeof(segmentOn));
-        memcpy(segmentOff, segmentOff_B, sizeof(segmentOff));
-    } else {
-        // Low level, copy A array
-        ESP_LOGW(TAG, "Servo mode detected: A");
-        memcpy(segmentOn, segmentOn_A, sizeof(segmentOn));
-        memcpy(segmentOff, segmentOff_A, sizeof(segmentOff));
-    }        
+    // High level selects the B profile, low level the A profile
+    ESP_LOGW(TAG, "Servo mode detected: %s", kServoProfiles[Servo_Mode_].name);
 }
 
 CyberClock::CyberClock() {
@@ -606,14 +1119,15 @@ CyberClock::CyberClock() {
     alarm_time_ = -1;
     // Load settings
     LoadSettings();
+    LoadTelemetry();
     InitializeCurrentPosition(); // Initialize servo current position
     // Display 8888 first
-    TaskUpdateDisplay(8, 8, 8, 8);// Initialize to 8888
+    TaskUpdateDisplay(UniformGlyphs(8));// Initialize to 8888
     ESP_LOGD(TAG, "CyberClock initialized, display set to 8888");
     // Create timer (always create, regardless of whether driver is available)
     clock_timer_ = xTimerCreate(
         "ClockTimer", 
-        pdMS_TO_TICKS(1000), 
+        pdMS_TO_TICKS(TICK_PERIOD_MS), 
         pdTRUE, 
         this, 
         TimerCallback
@@ -625,27 +1139,40 @@ CyberClock::CyberClock() {
 }
 
 
-void CyberClock::SetPWM(i2c_master_dev_handle_t dev_handle, uint8_t channel, uint16_t on, uint16_t off) {
-    if (!servo_driver_available_ || !dev_handle) return;
-    if (debug_servo_disabled_) return;
+// Write LEDn_ON_L..LEDn_OFF_H of one PCA9685 output in a single auto-increment transaction.
+// Returns false only when the I2C write failed.
+bool CyberClock::SetPWM(i2c_master_dev_handle_t dev_handle, uint8_t output, uint16_t on, uint16_t off) {
+    if (!servo_driver_available_ || !dev_handle) return true;
+    if (debug_servo_disabled_) return true;
 
-    // PCA9685 pin mapping between silk screen and actual index
-    const int pwm_pin_mapping[14] = {8, 9, 10, 11, 12, 13, 0, 1, 2, 3, 4, 5, 6, 7};
-    uint8_t real_channel = pwm_pin_mapping[channel];
-    if (!SafeI2CWrite(dev_handle, 0x06 + 4 * real_channel, on & 0xFF) ||
-        !SafeI2CWrite(dev_handle, 0x07 + 4 * real_channel, on >> 8) ||
-        !SafeI2CWrite(dev_handle, 0x08 + 4 * real_channel, off & 0xFF) ||
-        !SafeI2CWrite(dev_handle, 0x09 + 4 * real_channel, off >> 8)) {
-        ESP_LOGD(TAG, "PWM set failed on channel %d", real_channel);
+    uint8_t write_buf[5] = {(uint8_t)(0x06 + 4 * output), (uint8_t)(on & 0xFF), (uint8_t)(on >> 8),
+                            (uint8_t)(off & 0xFF), (uint8_t)(off >> 8)};
+    if (!SafeI2CWriteBurst(dev_handle, write_buf, sizeof(write_buf))) {
+        ESP_LOGD(TAG, "PWM set failed on output %d", output);
+        return false;
     }
+    return true;
 }
 
 // Safe I2C write
 bool CyberClock::SafeI2CWrite(i2c_master_dev_handle_t dev_handle, uint8_t reg, uint8_t value) {
-
     uint8_t write_buf[2] = {reg, value};
+    return SafeI2CWriteBurst(dev_handle, write_buf, sizeof(write_buf));
+}
+
+// Safe I2C write of a register address followed by consecutive register values
+bool CyberClock::SafeI2CWriteBurst(i2c_master_dev_handle_t dev_handle, const uint8_t* buf, size_t len) {
+    if (wake_change_us_ != 0) {
+        PowerManager::GetInstance().RecordWake(esp_timer_get_time() - wake_change_us_);
+        wake_change_us_ = 0;
+    }
     for (int retry = 0; retry < MAX_I2C_RETRIES; retry++) {
-        esp_err_t ret = i2c_master_transmit(dev_handle, write_buf, sizeof(write_buf), pdMS_TO_TICKS(100));
+        const bool timed = self_test_.Running();
+        int64_t start_us = timed ? esp_timer_get_time() : 0;
+        esp_err_t ret = i2c_master_transmit(dev_handle, buf, len, pdMS_TO_TICKS(100));
+        if (timed) {
+            self_test_.RecordI2C(esp_timer_get_time() - start_us, ret == ESP_OK);
+        }
         if (ret == ESP_OK) {
             return true;
         }
@@ -658,6 +1185,145 @@ bool CyberClock::SafeI2CWrite(i2c_master_dev_handle_t dev_handle, uint8_t reg, u
 
 
 
+// Set one servo channel (0 ~ SERVO_CHANNEL_NUM - 1) without waiting
+void CyberClock::SetChannelPWM(int channel, int position) {
+    int driver, output;
+    if (!LookupPwmOutput(channel, &driver, &output)) return;
+    if (!SetPWM(dev_handles_[driver], output, 0, position)) {
+        telemetry_.RecordI2CFailure(channel);
+    }
+}
+
+// Move every servo to positions[] without waiting. Each driver gets one I2C burst that
+// covers its changed outputs; unchanged outputs inside that range are rewritten as they are.
+void CyberClock::WriteFrame(const int* positions) {
+    int channel = 0;
+    for (int driver = 0; driver < kDisplayTopology.driver_num; driver++) {
+        const PwmDriverConfig& config = kDisplayTopology.drivers[driver];
+        const int first_channel = channel;
+        uint16_t off[PWM_DRIVER_OUTPUTS] = {0}; // Outputs without a servo stay off
+        int first = PWM_DRIVER_OUTPUTS;
+        int last = -1;
+        for (int i = 0; i < config.channel_num; i++, channel++) {
+            int output = config.output_map[i];
+            off[output] = positions[channel];
+            telemetry_.RecordWrite(channel, positions[channel], ANIM_FRAME_MS);
+            if (positions[channel] != servos_.position[channel]) {
+                trace_.RecordPosition(TraceTimeMs(), channel, positions[channel], TRACE_FRAME);
+                live_state_.position[channel] = positions[channel];
+                live_state_.target[channel] = positions[channel];
+                first = std::min(first, output);
+                last = std::max(last, output);
+                servos_.position[channel] = positions[channel];
+            }
+        }
+        if (last < 0) continue; // Nothing changed on this driver
+        if (!servo_driver_available_ || debug_servo_disabled_ || !dev_handles_[driver]) continue;
+
+        uint8_t write_buf[1 + 4 * PWM_DRIVER_OUTPUTS];
+        size_t len = 0;
+        write_buf[len++] = 0x06 + 4 * first; // LEDn_ON_L of the first changed output
+        for (int output = first; output <= last; output++) {
+            write_buf[len++] = 0; // ON at 0
+            write_buf[len++] = 0;
+            write_buf[len++] = off[output] & 0xFF;
+            write_buf[len++] = off[output] >> 8;
+        }
+        if (!SafeI2CWriteBurst(dev_handles_[driver], write_buf, len)) {
+            ESP_LOGD(TAG, "Frame write failed on driver 0x%02X", config.address);
+            for (int i = 0; i < config.channel_num; i++) {
+                int output = config.output_map[i];
+                if (output >= first && output <= last) telemetry_.RecordI2CFailure(first_channel + i);
+            }
+        }
+    }
+}
+
+// Execute servo movement for one engine step
+void CyberClock::WriteChannel(int channel, int position) {
+    SetChannelPWM(channel, position);
+    telemetry_.RecordWrite(channel, position, SERVO_STEP_DELAY_MS);
+    trace_.RecordPosition(TraceTimeMs(), channel, position, TRACE_STEP);
+    live_state_.position[channel] = position;
+    StepDelay(SERVO_STEP_DELAY_MS);
+}
+
+// Delay between servo steps, counted as waiting time while the self test runs
+void CyberClock::StepDelay(int ms) {
+    if (!self_test_.Running()) {
+        vTaskDelay(pdMS_TO_TICKS(ms));
+        return;
+    }
+    int64_t start_us = esp_timer_get_time();
+    vTaskDelay(pdMS_TO_TICKS(ms));
+    self_test_.RecordWait(esp_timer_get_time() - start_us);
+}
+
+// Play an animation frame by frame, blocking until its last keyframe
+void CyberClock::RunAnimation(const Animation& animation) {
+    if (!servo_driver_available_) return;
+
+    // The player owns the servos while it runs, so only start from a settled display
+    bool engine_idle = false;
+    if (xSemaphoreTake(task_queue_mutex_, pdMS_TO_TICKS(100)) == pdTRUE) {
+        engine_idle = motion_engine_.Empty();
+        xSemaphoreGive(task_queue_mutex_);
+    }
+    if (!engine_idle) {
+        ESP_LOGW(TAG, "Animation %s skipped, servos are still moving", animation.name);
+        return;
+    }
+
+    AnimationPlayer player;
+    int conflict = player.Start(animation, kServoProfiles[Servo_Mode_], servos_.offset, servos_.position);
+    if (conflict >= 0) {
+        ESP_LOGE(TAG, "Animation %s not played, keyframe %d makes arms collide", animation.name, conflict);
+        return;
+    }
+
+    // Frames are paced from the start time: a late frame is dropped rather than
+    // shifting the rest of the timeline
+    const int frame_num = player.FrameNum();
+    const int64_t frame_us = ANIM_FRAME_MS * 1000;
+    int positions[SERVO_CHANNEL_NUM];
+    int dropped_frames = 0;
+    int64_t start_us = esp_timer_get_time();
+    TickType_t last_wake = xTaskGetTickCount();
+    for (int frame = 0; frame < frame_num; ) {
+        player.Sample(frame, positions);
+        int64_t frame_start_us = esp_timer_get_time();
+        frame_jitter_.Record(frame_start_us - (start_us + frame * frame_us));
+        WriteFrame(positions);
+        int64_t frame_end_us = esp_timer_get_time();
+        PublishState();
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(ANIM_FRAME_MS));
+        if (self_test_.Running()) {
+            self_test_.RecordFrame(frame_end_us - frame_start_us);
+            self_test_.RecordWait(esp_timer_get_time() - frame_end_us);
+        }
+
+        // The last frame is never dropped, it holds the final pose
+        int next = std::max(frame + 1, (int)((esp_timer_get_time() - start_us) / frame_us));
+        if (frame < frame_num - 1) {
+            next = std::min(next, frame_num - 1);
+        }
+        dropped_frames += next - frame - 1;
+        frame = next;
+    }
+
+    ESP_LOGI(TAG, "Animation %s played: %d frames, %d dropped, %lld ms", animation.name, frame_num,
+             dropped_frames, (long long)((esp_timer_get_time() - start_us) / 1000));
+}
+
+void CyberClock::ApplyHourlyAnimation(const Animation* animation) {
+    hourly_animation_ = animation;
+
+    const char* name = animation ? animation->name : "none";
+    Settings settings("cyberclock",true);
+    settings.SetString("hourly_anim", name);
+    ESP_LOGI(TAG, "Hourly animation set to %s", name);
+}
+
 void CyberClock::ExecuteTask() {
     //ESP_LOGW(TAG, "Enter ExecuteTask");
 
@@ -665,95 +1331,22 @@ void CyberClock::ExecuteTask() {
     if (xSemaphoreTake(servo_mute_mode_semaphore_, 0) == pdTRUE) {
         //ESP_LOGW(TAG, "Acquired servo_mute_mode_semaphore_, start executing tasks");
 
-        // ESP_LOGW(TAG, "Tasks to execute:");
-        // for (const auto& task : servo_states_) {
-        //     ESP_LOGW(TAG, "channel=%d, current_position=%d, target_position=%d, front_channel=%d, state=%d",
-        //              task.channel, task.current_position, task.target_position, task.front_channel, task.state);
-        // }
-        // ESP_LOGW(TAG, "-------------------");
-
-        int step_size = 50; // Step size per move
+        // ESP_LOGW(TAG, "Scripts to execute: %d, servos moving: %d",
+        //          motion_engine_.ScriptsAlive(), motion_engine_.MovesActive());
 
         bool tasks_remaining = true;
 
         // Loop until all tasks are finished
         while (tasks_remaining) {
-            tasks_remaining = false; // Assume no remaining tasks
-            int tasks_executed = 0;  // Number of tasks executed in this round
             bool restart_iteration = false; // Flag to restart iteration
 
             // Lock task array
             if (xSemaphoreTake(task_queue_mutex_, pdMS_TO_TICKS(100)) == pdTRUE) {
-                // Iterate task array
-                for (auto it = servo_states_.begin(); it != servo_states_.end(); ) {
-                    ServoState& task = *it;
-
-                    // Control smooth movement
-                    step_size = (task.smooth) ? 5 : 50; // Smooth: step=5, else step=50
-                    // if(task.smooth) {
-                    //     ESP_LOGW(TAG, "Smooth moving enabled for channel %d", task.channel);
-                    // }
-
-                    // Remove finished task
-                    if (task.current_position == task.target_position) {
-                        //ESP_LOGI(TAG, "Task completed and removed: channel=%d", task.channel);
-                        it = servo_states_.erase(it); // Remove and update iterator
-                        continue;
-                    }
-
-                    // Check if preceding task is finished
-                    if (task.front_channel != -1) { // Has dependency
-                        for (auto check_it = servo_states_.begin(); check_it != it; ++check_it) {
-                            if (check_it->channel == task.front_channel) { // Find preceding task by channel
-                                if (check_it->state != 1) { // If preceding task not finished
-                                    //ESP_LOGI(TAG, "Front task not completed: front_channel=%d", task.front_channel);
-                                    restart_iteration = true; // Mark to restart iteration
-                                    break;
-                                }else {
-                                    break;
-                                }
-                            }
-                        }
-                        if (restart_iteration) break; // Restart from beginning
-                    }
-
-                    // If current task can execute, step once
-                    tasks_remaining = true; // Mark there are unfinished tasks
-                    int step = (task.current_position < task.target_position) ? step_size : -step_size;
-
-                    // If step will overshoot, set to target
-                    if (abs(task.target_position - task.current_position) <= step_size) {
-                        task.current_position = task.target_position;
-                        clock_current_position_[task.channel] = task.target_position; // Update current servo position
-                    } else {
-                        task.current_position += step;
-                    }
-
-                    // Execute servo movement
-                    i2c_master_dev_handle_t dev_handle = (task.channel < 14) ? dev_handle_h : dev_handle_m;
-                    int adjusted_channel = (task.channel < 14) ? task.channel : (task.channel - 14);
-                    SetPWM(dev_handle, adjusted_channel, 0, task.current_position);
-                    vTaskDelay(pdMS_TO_TICKS(15));
-
-                    //ESP_LOGI(TAG, "Task step executed: channel=%d, current_position=%d, target_position=%d",
-                    //         task.channel, task.current_position, task.target_position);
-
-                    // Mark task as finished if done
-                    if (task.current_position == task.target_position) {
-                        //ESP_LOGI(TAG, "Task completed: channel=%d", task.channel);
-                        task.state = 1;
-                    }
-
-                    // Check max concurrent tasks
-                    tasks_executed++;
-                    if (tasks_executed >= MAX_SERVO_TASK_NUM) {
-                        //ESP_LOGI(TAG, "Reached MAX_SERVO_TASK_NUM in this round, moving to next round");
-                        restart_iteration = true; // Reached max, restart
-                        break;
-                    }
-
-                    ++it; // Next task
-                }
+                // Step at most MAX_SERVO_TASK_NUM tasks, WriteChannel moves the servos
+                MotionRound round = motion_engine_.RunRound(servos_.position, *this);
+                tasks_remaining = round.tasks_remaining;
+                restart_iteration = round.restart;
+                PublishState(); // Once per round, readers see all of its steps together
 
                 xSemaphoreGive(task_queue_mutex_);
             } else {
@@ -766,7 +1359,7 @@ void CyberClock::ExecuteTask() {
                 continue;
             }
 
-            vTaskDelay(pdMS_TO_TICKS(15));
+            StepDelay(SERVO_STEP_DELAY_MS);
         }
 
         //ESP_LOGI(TAG, "All tasks completed");
@@ -778,14 +1371,14 @@ void CyberClock::ExecuteTask() {
 }
 
 // idle clock
-void CyberClock::IdleClock() {
+void CyberClock::ApplyIdleClock() {
     if (!servo_driver_available_) {
         ESP_LOGW(TAG, "Cannot idle clock - servo driver not available");
         return;
     }
 
     ESP_LOGI(TAG, "Idle CyberClock");
-    current_mode_ = MODE_03_IDLE;
+    display_arbiter_.Claim(DISPLAY_SOURCE_WEB, MODE_03_IDLE);
 }
 
 
@@ -800,23 +1393,16 @@ CyberClock::~CyberClock() {
         vSemaphoreDelete(servo_mute_mode_semaphore_);
     }
     
-    if (servo_task_queue_ != nullptr) {
-        vQueueDelete(servo_task_queue_);
-    }
-
     if (clock_timer_) {
         xTimerStop(clock_timer_, 0);
         xTimerDelete(clock_timer_, 0);
     }
     
     if (servo_driver_available_) {
-        i2c_master_bus_rm_device(dev_handle_h);
-        i2c_master_bus_rm_device(dev_handle_m);
+        for (int i = 0; i < kDisplayTopology.driver_num; i++) {
+            i2c_master_bus_rm_device(dev_handles_[i]);
+        }
         i2c_del_master_bus(bus_handle);
     }
-
-    if (display_mutex_ != nullptr) {
-        vSemaphoreDelete(display_mutex_);
-    }
 }
 
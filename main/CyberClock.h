@@ -7,38 +7,55 @@
 #include <vector>
 #include "settings.h"
 #include <sys/time.h>
+#include "display_topology.h"
+#include "motion_engine.h"
+#include "motion_planner.h"
+#include "motion_animation.h"
+#include "servo_telemetry.h"
+#include "motion_trace.h"
+#include "self_test.h"
+#include "tick_monitor.h"
+#include "clock_timer.h"
+#include "clock_command.h"
+#include "display_frame.h"
+#include "clock_state.h"
+#include "text_display.h"
+#include "display_arbiter.h"
+#include "speed_profile.h"
+#include "power_manager.h"
 
 #define I2C_MASTER_NUM I2C_NUM_1
 
-#define PCA9685_ADDR_H 0x47     
-#define PCA9685_ADDR_M 0x41   
+#define TICK_CHANGE_MARGIN_MS 10 // 在显示变化后一个 FreeRTOS tick 刷新
+#define CLOCK_NO_DEADLINE INT64_MAX // 模式显示不会再变化，只有命令能唤醒时钟
+#define PLAN_RETRY_MS 100        // 帧没能排入时过这么久再规划（不少于一个动画帧 ANIM_FRAME_MS），不空转
+
+// 驱动板地址和通道映射见 display_topology.cc
+#define PCA9685_MODE1_AI 0x20   // MODE1 auto-increment, LEDn registers are written in one burst
 
 #define MAX_I2C_RETRIES 3
 #define I2C_ERROR_THRESHOLD 5
 
-#define MAX_SERVO_TASK_NUM 5 // 同时运行的最大舵机任务数
-
 #define    MODE_00_NORMAL_CLOCK 0
 #define    MODE_01_SET_NUMBER 1
 #define    MODE_02_SET_COUNTDOWN 2
 #define    MODE_03_IDLE 3
 #define    MODE_04_SET_TIMER 4    
+#define    MODE_05_TEXT 5
 #define    MODE_98_ADJUST 98
 #define    MODE_99_SHUTDOWN 99
 #define    MODE_100_TEST 100
 
-class CyberClock {
+class CyberClock : public MotionOutput {
 private:
-    //二值信号量
-    SemaphoreHandle_t display_mutex_;
+    // 模式逻辑写入、运动规划读取的目标帧（双缓冲）
+    DisplayFrameBuffer display_frames_;
     //全局的时钟数字
     int a_number_ = 0;
     int b_number_ = 0;
     int c_number_ = 0;
     int d_number_ = 0;
 
-    int servo_offsets_[28] = {0}; // 每个舵机的偏移量，初始为 0
-
 
     // 配置参数
     int timezone_offset_ = 8; // 时区偏移（单位：小时）
@@ -50,8 +67,8 @@ private:
     int sleep_end_hour_ ;   // 晚上睡眠结束时间（小时）
     int sleep_start_minute_ ; // 晚上睡眠开始时间（分钟）
     int sleep_end_minute_ ;   // 晚上睡眠结束时间（分钟）
-    int countdown_time_ = 0; // 倒计时秒数
-    int timer_tick_ = 0; // 定时器滴答计数
+    ClockTimer countdown_; // 倒计时，按 esp_timer 时间戳计算
+    ClockTimer stopwatch_; // 秒表（计时器模式）
 
 
     int Servo_Mode_ = 0; // 舵机模式，0表示A模式，1表示B模式
@@ -59,8 +76,12 @@ private:
     //语音调试模式
     bool debug_mode_ = false; //可以通过语音打开调试模式
 
-    //静音移动（仅正常显示时有效），可以保证日常显示静音
-    bool servo_mute_mode_ = true; // 静音模式开关，启用后，舵机转动缓和
+    // 每个模式的舵机速度（SpeedProfileId），夜间时段可统一改用 night_speed_，保存在设置里
+    // 静音模式即时钟模式用 silent，其余模式默认 fast
+    int mode_speed_[SPEED_MODE_NUM] = {SPEED_SILENT, SPEED_FAST, SPEED_FAST, SPEED_FAST, SPEED_FAST, SPEED_FAST};
+    int night_speed_ = SPEED_NONE; // 睡眠时段内所有模式的速度，SPEED_NONE 表示不覆盖
+    int applied_speed_ = SPEED_FAST; // 最近一次规划的转换使用的速度
+    SpeedMonitor speed_monitor_;     // 每种速度实测的转换耗时
     bool debug_servo_disabled_ = false; //是否驱动舵机运动，如果为true则不要运动舵机
     SemaphoreHandle_t servo_mute_mode_semaphore_; // 信号量，用于控制ExecuteTask
     SemaphoreHandle_t task_ready_semaphore_ = nullptr;// 添加一个信号量，用于控制任务执行的开始
@@ -69,6 +90,7 @@ private:
     // 状态变量
     int clock_12_hour_ = 0; // 12小时制时钟
     TimerHandle_t clock_timer_;
+    TaskHandle_t clock_task_ = nullptr; // 执行时钟逻辑和舵机输出的任务，定时器和命令通知它
     int i2c_error_count_ = 0;
 
     int alarm_time_ = -1; // -1 表示无闹钟
@@ -76,90 +98,158 @@ private:
  
     // 硬件句柄
     i2c_master_bus_handle_t bus_handle = nullptr;
-    i2c_master_dev_handle_t dev_handle_h = nullptr;
-    i2c_master_dev_handle_t dev_handle_m = nullptr;
+    i2c_master_dev_handle_t dev_handles_[MAX_PWM_DRIVERS] = {}; // 按 kDisplayTopology 顺序
  
-    // 数字显示配置
-    const int digits[12][7] = {
-        {1, 1, 1, 1, 1, 1, 0}, {0, 1, 1, 0, 0, 0, 0},
-        {1, 1, 0, 1, 1, 0, 1}, {1, 1, 1, 1, 0, 0, 1},
-        {0, 1, 1, 0, 0, 1, 1}, {1, 0, 1, 1, 0, 1, 1},
-        {1, 0, 1, 1, 1, 1, 1}, {1, 1, 1, 0, 0, 0, 0},
-        {1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 0, 1, 1},
-        {0, 0, 0, 0, 0, 0, 0}, // 0xA 全关
-        {0, 0, 0, 0, 0, 0, 1}  // 0xB idle
-
-    };
-
-    // 舵机位置参数，实测有效范围是100~550，中间值是325
-    const int segmentOn_A[28] = { 110, 110, 120, 330, 330, 310, 110, 
-                                  110, 110, 120, 330, 330, 310, 110,
-                                  110, 110, 120, 330, 330, 310, 110, 
-                                  110, 110, 120, 330, 330, 310, 110};
-    const int segmentOff_A[28] = {300, 300, 310, 140, 140, 120, 300,
-                                  300, 300, 310, 140, 140, 120, 300, 
-                                  300, 300, 310, 140, 140, 120, 300, 
-                                  300, 300, 310, 140, 140, 120, 300};
-
-    const int segmentOn_B[28] = {   325, 325, 325, 325, 325, 325, 325, 
-                                    325, 325, 325, 325, 325, 325, 325,
-                                    325, 325, 325, 325, 325, 325, 325, 
-                                    325, 325, 325, 325, 325, 325, 325};
-    const int segmentOff_B[28] = {  525, 525, 525, 125, 125, 125, 525,
-                                    525, 525, 525, 125, 125, 125, 525, 
-                                    525, 525, 525, 125, 125, 125, 525, 
-                                    525, 525, 525, 125, 125, 125, 525};
-    
-    // const int segment_smile[28] = { 325, 525, 525, 125, 125, 125, 525,
-    //                                 325, 325, 525, 125, 125, 325, 325, 
-    //                                 325, 325, 525, 125, 125, 325, 325, 
-    //                                 325, 525, 525, 125, 125, 125, 525};
-    
-    int segmentOn[28]; // 舵机打开位置
-    int segmentOff[28]; // 舵机关闭位置
-     
-    // 舵机的位置
-    int clock_current_position_[28]; //当前位置
-    int clock_target_position_[28]; // 目标位置
+    // 舵机的位置和偏移量，偏移量初始为 0
+    ServoArrays servos_ = {};
+    MotionEngine motion_engine_; // 待执行的舵机移动任务
+    const Animation* pending_animation_ = nullptr; // 下一次 tick 要播放的动画
+    const Animation* hourly_animation_ = nullptr;  // 整点播放的动画，nullptr 表示不播放
+    ServoTelemetry telemetry_;          // 每个舵机的行程、次数、负载时间和 I2C 失败次数
+    TickType_t telemetry_saved_tick_ = 0; // 上次写入 NVS 的时间
+    MotionTrace trace_;                 // 舵机指令记录，网页上开启
+    TextDisplay text_display_;          // MODE_05_TEXT 文字和滚动帧
+    SelfTest self_test_;                // MODE_100_TEST 自检基准测试
+    DisplayArbiter display_arbiter_{MODE_00_NORMAL_CLOCK}; // 各来源的显示请求按优先级和租期决定 current_mode_
+    TickMonitor tick_monitor_;          // 时钟定时器的延迟、漏拍和超时统计
+    FrameJitter frame_jitter_;          // 动画帧实际开始时间相对计划的延迟
+    int64_t clock_deadline_us_ = 0;     // 下一次需要刷新的时刻（esp_timer），定时器睡到这个时刻
+    int64_t wake_change_us_ = 0;        // 本次唤醒要显示的变化时刻，第一次写舵机时统计唤醒延迟
+    MpscRing<ClockCommand, CLOCK_COMMAND_NUM> commands_; // 其他任务发来的命令，由时钟任务执行
+    CommandLatency command_latency_;    // 命令从发出到执行的延迟
+    CommandCoalescer command_coalescer_; // 连续的显示命令合并成一次转换
+    ClockState live_state_ = {};        // 时钟任务维护的舵机状态
+    SeqLock<ClockState> state_snapshot_; // live_state_ 的发布版本，其他任务无锁读取
     bool sntp_cb_set = false;
 
-    void GetTargetPosition(int a, int b, int c, int d);
     bool InitI2CBus();
     bool InitPCA9685(i2c_master_dev_handle_t* dev_handle, uint8_t addr);
     bool InitializeServos();
     void InitializeCurrentPosition();
     void CheckSleepTime() ; 
-    void AddServoTask(int ch, int start_position, int to_position, int front_channel = -1, bool smooth = false);
-    void TaskUpdateDisplay(int a, int b, int c, int d, bool smooth = false);
+    bool AddServoTask(ServoState task);
+    // 每一位数字显示的字形，六位数版本的第 5、6 位是秒
+    struct DisplayGlyphs {
+        int glyph[CLOCK_DIGIT_NUM];
+    };
+    static DisplayGlyphs UniformGlyphs(int glyph);
+    static DisplayGlyphs DigitGlyphs(int a, int b, int c, int d); // Digits after the fourth are off
+    // 每个模式的显示逻辑：期望的帧和它下一次变化的时刻
+    struct ModeFrame {
+        bool show;              // false: leave the display as it is
+        DisplayGlyphs glyphs;
+        int64_t next_change_us; // esp_timer time, CLOCK_NO_DEADLINE if it never changes by itself
+    };
+    typedef ModeFrame (CyberClock::*ModeHandler)(int64_t now_us);
+    struct ModeEntry {
+        int mode;
+        ModeHandler handler;
+        int speed_mode; // SpeedMode whose profile its transitions use
+    };
+    static const ModeEntry kModeHandlers[];
+    ModeFrame ShutdownFrame(int64_t now_us);
+    ModeFrame IdleFrame(int64_t now_us);
+    ModeFrame NumberFrame(int64_t now_us);
+    ModeFrame CountdownFrame(int64_t now_us);
+    ModeFrame StopwatchFrame(int64_t now_us);
+    ModeFrame TextFrame(int64_t now_us);
+    ModeFrame NormalClockFrame(int64_t now_us);
+    ModeFrame SelfTestFrame(int64_t now_us);
+    ModeFrame AdjustFrame(int64_t now_us);
+    int64_t NextSleepEventUs(int64_t now_us) const;
+    int64_t NextTelemetrySaveUs(int64_t now_us) const;
+    void TaskUpdateDisplay(const DisplayGlyphs& glyphs, int speed = SPEED_FAST);
+    int ApplyDisplayFrame();
+    void PublishState();
     void UpdateIdleClock();
     void LoadSettings();
+    void LoadTelemetry();
     void InitialMutexAndSemaphore();
     //void MoveServoStepByStep(i2c_master_dev_handle_t dev_handle, int channel, int start_position, int target_position);
-    void SetPWM(i2c_master_dev_handle_t dev_handle, uint8_t channel, uint16_t on, uint16_t off);
+    bool SetPWM(i2c_master_dev_handle_t dev_handle, uint8_t output, uint16_t on, uint16_t off);
     bool SafeI2CWrite(i2c_master_dev_handle_t dev_handle, uint8_t reg, uint8_t value);
+    bool SafeI2CWriteBurst(i2c_master_dev_handle_t dev_handle, const uint8_t* buf, size_t len);
     void ExecuteTask();
+    void StepDelay(int ms);
+    void WriteChannel(int channel, int position) override;
+    void SetChannelPWM(int channel, int position);
+    void WriteFrame(const int* positions);
+    void RunAnimation(const Animation& animation);
+    void RunTick();
     void OnTimerTick();
+    int NextTickDelayMs(int64_t now_us) const;
+    DisplayGlyphs DurationGlyphs(int seconds);
+    void RunSelfTestStep();
+    bool PostCommand(ClockCommand command);
+    int DrainCommands();
+    // Command handlers, clock task only
+    void ApplyShutdownClock();
+    void ApplyIdleClock();
+    void ApplyShowTime();
+    void ApplyNumber(int a, int b, int c, int d);
+    void ApplyText(const char* text);
+    void ApplyCountDown(int seconds);
+    void ApplyTimer(int operation);
+    void ApplyServoSilentMode(bool mode);
+    void ApplySpeed(int speed_mode, int profile);
+    int ModeSpeed(int speed_mode) const;
+    bool InSleepWindow() const;
+    void Apply12HourMode(bool mode);
+    void ApplySleepTime(bool mode, int start_hour, int start_minute, int end_hour, int end_minute);
+    void ApplyHourlyAnimation(const Animation* animation);
+    void ApplyStartSelfTest();
+    void ApplyPreview(int mode);
+    void ApplyButtonClick();
+    void ApplyServoOffsets(const int16_t* offsets);
+    void Arbitrate(int64_t now_us);
     void DetectServoMode();//判断是A模式还是B模式
     static void TimerCallback(TimerHandle_t xTimer);
 
 public:
-    QueueHandle_t servo_task_queue_; // 队列，用于存储舵机移动任务
     SemaphoreHandle_t task_queue_mutex_; // 互斥锁，用于保护任务队列
 
     int current_mode_ = MODE_00_NORMAL_CLOCK; // 当前模式，默认为正常时钟模式
 
     static CyberClock& GetInstance();
+    void Run(); // 时钟任务主循环，不返回
     int GetCurrentMode() const { return current_mode_; }
+    // 以下设置命令可在任意任务调用，进入命令队列，由时钟任务在下一拍执行
     void ShutdownClock();
     void IdleClock();
     void ShowTime();
     void SetNumber(int a, int b, int c, int d);
+    bool SetText(const char* text); // 字母、数字和常用符号，放不下时滚动
     void SetCountDown(int seconds);
     void SetTimer(int operation);
     void SetServoSilentMode(bool mode);
+    // 设置某个模式（SpeedModeName，"night" 为夜间覆盖）的速度，profile 为 kSpeedProfiles 名称，夜间可用 "none"
+    bool SetSpeed(const char* mode, const char* profile);
+    int GetModeSpeed(int speed_mode) const { return mode_speed_[speed_mode]; }
+    int GetNightSpeed() const { return night_speed_; }
+    const SpeedMonitor& GetSpeedMonitor() const { return speed_monitor_; }
     void Set12HourMode(bool mode);
     void SetSleepTime(bool mode, int start_hour, int start_minute, int end_hour, int end_minute);
-    int* GetServoOffsets() { return servo_offsets_; }
+    void TimeChanged(); // 系统时间被设置或时区改变，时钟按新时间刷新
+    void PreviewDisplay(int mode); // 网页打开时的预览（MODE_98_ADJUST 或 MODE_04_SET_TIMER），优先级最低
+    void ButtonClick();            // K1 单击：关闭显示，再按一次恢复
+    bool SetServoOffsets(const int* offsets); // 校准页面：所有舵机的偏移量，由时钟任务应用并保存
+    int GetServoMode() const { return Servo_Mode_; }
+    bool PlayAnimation(const char* name);
+    bool SetHourlyAnimation(const char* name);
+    const char* GetHourlyAnimation() const { return hourly_animation_ ? hourly_animation_->name : "none"; }
+    const ServoTelemetry& GetTelemetry() const { return telemetry_; }
+    int GetTelemetryAgeSeconds() const; // Seconds since the counters were last saved
+    void SaveTelemetry(bool force);
+    MotionTrace& GetTrace() { return trace_; }
+    const CommandLatency& GetCommandLatency() const { return command_latency_; }
+    // Consistent copy of the live servo state from any task, false if the clock kept writing
+    bool GetState(ClockState& state) const { return state_snapshot_.Read(state); }
+    uint32_t GetStateVersion() const { return state_snapshot_.Version(); }
+    void StartSelfTest();
+    const SelfTest& GetSelfTest() const { return self_test_; }
+    const TickMonitor& GetTickMonitor() const { return tick_monitor_; }
+    FrameJitter& GetFrameJitter() { return frame_jitter_; }
+    const DisplayArbiter& GetDisplayArbiter() const { return display_arbiter_; }
 
 private:
     CyberClock();
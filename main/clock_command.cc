@@ -0,0 +1,49 @@
+#include "clock_command.h"
+
+#include <algorithm>
+
+void CommandLatency::Record(int64_t latency_us) {
+    uint32_t us = (uint32_t)std::max<int64_t>(latency_us, 0);
+    uint32_t ms = us / 1000;
+    int bucket = 0;
+    while (bucket < COMMAND_LATENCY_BUCKETS - 1 && ms >= (1u << bucket)) {
+        bucket++;
+    }
+    stats_.hist[bucket]++;
+    stats_.max_us = std::max(stats_.max_us, us);
+    stats_.total_us += us;
+    stats_.applied++;
+    published_.Write(stats_);
+}
+
+void CommandLatency::Coalesce(int commands) {
+    if (commands == 0) return;
+    stats_.coalesced += commands;
+    published_.Write(stats_);
+}
+
+bool CommandLatency::Snapshot(CommandLatencyStats& stats) const {
+    if (!published_.Read(stats)) return false;
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    return true;
+}
+
+void CommandCoalescer::Add(int64_t enqueue_us) {
+    if (held_ == 0) {
+        first_us_ = enqueue_us;
+        leading_ = enqueue_us - last_us_ >= COMMAND_COALESCE_MS * 1000LL;
+    }
+    last_us_ = enqueue_us;
+    held_++;
+}
+
+int64_t CommandCoalescer::ReleaseUs() const {
+    if (held_ == 0 || leading_) return 0;
+    return std::min(last_us_ + COMMAND_COALESCE_MS * 1000LL, first_us_ + COMMAND_COALESCE_MAX_MS * 1000LL);
+}
+
+int CommandCoalescer::Flush() {
+    int replaced = std::max(held_ - 1, 0);
+    held_ = 0;
+    return replaced;
+}
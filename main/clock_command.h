@@ -0,0 +1,151 @@
+#ifndef CLOCK_COMMAND_H
+#define CLOCK_COMMAND_H
+
+#include <stdint.h>
+#include <atomic>
+#include "display_topology.h"
+#include "seqlock.h"
+#include "text_display.h"
+
+// Commands from the web server and button tasks to the clock. Producers push them into a
+// lock-free ring; the clock drains it at the start of every tick, so the clock state has a
+// single writer. This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define CLOCK_COMMAND_NUM 16         // Ring slots, a power of two
+#define COMMAND_LATENCY_BUCKETS 12   // Enqueue-to-apply histogram: bucket 0 < 1 ms, bucket n < 2^n ms, the last is open
+#define COMMAND_COALESCE_MS 100      // Display commands closer together than this are shown as one transition
+#define COMMAND_COALESCE_MAX_MS 500  // A steady stream still shows its latest target this often
+
+enum ClockCommandType : uint8_t {
+    CLOCK_CMD_SET_NUMBER,     // args: four digits
+    CLOCK_CMD_SET_COUNTDOWN,  // args[0]: seconds
+    CLOCK_CMD_SET_TIMER,      // args[0]: 0 reset, 1 start, 2 stop
+    CLOCK_CMD_SHOW_TIME,
+    CLOCK_CMD_IDLE,
+    CLOCK_CMD_SHUTDOWN,
+    CLOCK_CMD_SILENT_MODE,    // args[0]: on
+    CLOCK_CMD_12_HOUR,        // args[0]: on
+    CLOCK_CMD_SLEEP_TIME,     // args: enable, start hour, start minute, end hour, end minute
+    CLOCK_CMD_PLAY_ANIMATION, // animation
+    CLOCK_CMD_HOURLY_ANIMATION, // animation, nullptr for none
+    CLOCK_CMD_SELF_TEST,
+    CLOCK_CMD_TIME_CHANGED,   // SNTP or a timezone change moved the wall clock
+    CLOCK_CMD_SET_TEXT,       // text
+    CLOCK_CMD_PREVIEW,        // args[0]: mode a web page previews
+    CLOCK_CMD_BUTTON_CLICK,
+    CLOCK_CMD_SPEED,          // args: SpeedMode (SPEED_MODE_NUM for the night override), SpeedProfileId
+    CLOCK_CMD_SET_OFFSETS,    // offsets: calibration of every servo
+};
+
+struct Animation;
+
+struct ClockCommand {
+    ClockCommandType type;
+    int32_t args[5];
+    const Animation* animation;
+    char text[TEXT_MAX_LEN + 1];
+    int16_t offsets[SERVO_CHANNEL_NUM];
+    int64_t enqueue_us; // Set by the producer when it posts the command
+};
+
+// Bounded multi-producer single-consumer ring. Every slot carries a sequence number: a
+// producer claims a position with one compare-and-swap on tail_ and publishes the slot by
+// storing position + 1; the consumer frees it by storing position + N. No locks, and a
+// producer never waits for another one except while losing the CAS.
+template <typename T, int N>
+class MpscRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Ring size must be a power of two");
+
+public:
+    MpscRing() {
+        for (int i = 0; i < N; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Any task. False when the ring is full.
+    bool Push(const T& value) {
+        uint32_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos % N];
+            int32_t diff = (int32_t)(slot.sequence.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // The consumer has not freed this slot yet
+            } else {
+                pos = tail_.load(std::memory_order_relaxed); // Another producer took it
+            }
+        }
+    }
+
+    // Consumer only. False when empty or the oldest slot is still being written.
+    bool Pop(T& value) {
+        Slot& slot = slots_[head_ % N];
+        if ((int32_t)(slot.sequence.load(std::memory_order_acquire) - (head_ + 1)) < 0) return false;
+        value = slot.value;
+        slot.sequence.store(head_ + N, std::memory_order_release);
+        head_++;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        T value;
+    };
+    Slot slots_[N];
+    std::atomic<uint32_t> tail_{0}; // Next position a producer claims
+    uint32_t head_ = 0;             // Next position the consumer reads
+};
+
+struct CommandLatencyStats {
+    uint32_t applied;
+    uint32_t dropped;    // Posted while the ring was full
+    uint32_t coalesced;  // Display commands whose target was replaced before it was shown
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t hist[COMMAND_LATENCY_BUCKETS];
+};
+
+// Written by the clock task (Record, Coalesce) and by producers (Drop). The clock task
+// publishes its counters after every change; readers on other tasks take a Snapshot().
+class CommandLatency {
+public:
+    void Record(int64_t latency_us);
+    void Drop() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+    void Coalesce(int commands);
+    // False when every try overlapped a publish, retry later
+    bool Snapshot(CommandLatencyStats& stats) const;
+
+private:
+    CommandLatencyStats stats_ = {};      // Clock task only
+    SeqLock<CommandLatencyStats> published_;
+    std::atomic<uint32_t> dropped_{0};
+};
+
+// Clock task only. Every command is still applied in order, but the display frame for a
+// burst of display commands (number, text, mode changes) is held back until the burst
+// pauses for COMMAND_COALESCE_MS, so the engine plans one transition to the latest target
+// instead of one per command. A display command after a quiet period is shown at once.
+class CommandCoalescer {
+public:
+    // A display command posted at enqueue_us was applied
+    void Add(int64_t enqueue_us);
+    // Time the mode frame may be shown again, 0 if it is not held back
+    int64_t ReleaseUs() const;
+    // The mode frame was shown, returns the commands whose targets it replaced
+    int Flush();
+
+private:
+    int held_ = 0;          // Display commands applied since the frame was last shown
+    bool leading_ = false;  // The first of them came after a quiet period
+    int64_t first_us_ = 0;
+    int64_t last_us_ = 0;
+};
+
+#endif // CLOCK_COMMAND_H
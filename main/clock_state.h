@@ -0,0 +1,22 @@
+#ifndef CLOCK_STATE_H
+#define CLOCK_STATE_H
+
+#include <stdint.h>
+#include "display_topology.h"
+#include "seqlock.h"
+
+// Live servo state published by the clock task for readers on other tasks (GET /state).
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+struct ClockState {
+    int16_t position[SERVO_CHANNEL_NUM]; // Last position written to each servo
+    int16_t target[SERVO_CHANNEL_NUM];   // Where the current plan takes it
+    int16_t offset[SERVO_CHANNEL_NUM];   // Calibration offset of each servo
+    int16_t mode;                        // MODE_*
+    int16_t owner;                       // DisplaySource the mode comes from
+    int16_t moves_active;                // Servos moving in the engine
+    int16_t scripts_alive;               // Planned moves not finished yet
+    uint32_t published_ms;               // Clock time of this snapshot
+};
+
+#endif // CLOCK_STATE_H
@@ -0,0 +1,75 @@
+#include "clock_timer.h"
+
+#include <algorithm>
+
+#define US_PER_SECOND 1000000LL
+
+void ClockTimer::StartCountdown(int64_t now_us, int seconds) {
+    countdown_ = true;
+    running_ = true;
+    start_us_ = now_us + std::clamp(seconds, 0, DURATION_HHMM_MAX) * US_PER_SECOND;
+    elapsed_us_ = 0;
+}
+
+void ClockTimer::StartStopwatch(int64_t now_us) {
+    if (countdown_) Reset();
+    if (running_) return;
+    running_ = true;
+    start_us_ = now_us;
+}
+
+void ClockTimer::Stop(int64_t now_us) {
+    if (!running_) return;
+    if (countdown_) {
+        elapsed_us_ = std::max<int64_t>(start_us_ - now_us, 0);
+    } else {
+        elapsed_us_ += now_us - start_us_;
+    }
+    running_ = false;
+}
+
+void ClockTimer::Reset() {
+    countdown_ = false;
+    running_ = false;
+    start_us_ = 0;
+    elapsed_us_ = 0;
+}
+
+int ClockTimer::Seconds(int64_t now_us) const {
+    if (countdown_) {
+        int64_t left_us = running_ ? std::max<int64_t>(start_us_ - now_us, 0) : elapsed_us_;
+        return (int)((left_us + US_PER_SECOND - 1) / US_PER_SECOND);
+    }
+    int64_t elapsed_us = elapsed_us_ + (running_ ? now_us - start_us_ : 0);
+    return (int)std::min<int64_t>(elapsed_us / US_PER_SECOND, DURATION_HHMM_MAX);
+}
+
+int64_t ClockTimer::NextChangeUs(int64_t now_us) const {
+    if (!running_) return -1;
+    const int seconds = Seconds(now_us);
+    const int unit = seconds > DURATION_MMSS_MAX ? 60 : 1; // HH:MM only changes every minute
+    const int64_t shown = seconds / unit * unit;
+    if (countdown_) {
+        // The display drops when the seconds left fall below the shown value
+        if (seconds == 0) return -1;
+        return (start_us_ - now_us) - (shown - 1) * US_PER_SECOND;
+    }
+    if (seconds >= DURATION_HHMM_MAX) return -1;
+    return (shown + unit) * US_PER_SECOND - (elapsed_us_ + now_us - start_us_);
+}
+
+void DurationDigits(int seconds, int* digits) {
+    seconds = std::clamp(seconds, 0, DURATION_HHMM_MAX);
+    int high, low;
+    if (seconds > DURATION_MMSS_MAX) {
+        high = seconds / 3600;
+        low = seconds / 60 % 60;
+    } else {
+        high = seconds / 60;
+        low = seconds % 60;
+    }
+    digits[0] = high / 10;
+    digits[1] = high % 10;
+    digits[2] = low / 10;
+    digits[3] = low % 10;
+}
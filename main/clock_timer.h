@@ -0,0 +1,39 @@
+#ifndef CLOCK_TIMER_H
+#define CLOCK_TIMER_H
+
+#include <stdint.h>
+
+// Countdown and stopwatch computed from monotonic timestamps (esp_timer_get_time() on the
+// clock), so late or skipped ticks never make them drift from real time.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define DURATION_MMSS_MAX 5999 // 99:59; longer durations are shown as HH:MM
+#define DURATION_HHMM_MAX (99 * 3600 + 59 * 60)
+
+class ClockTimer {
+public:
+    // Count down seconds from now_us
+    void StartCountdown(int64_t now_us, int seconds);
+    // Run the stopwatch, continuing from where Stop() left it
+    void StartStopwatch(int64_t now_us);
+    // Freeze the current value
+    void Stop(int64_t now_us);
+    void Reset();
+
+    bool Running() const { return running_; }
+    // Countdown: seconds left, rounded up, 0 once expired. Stopwatch: seconds elapsed, rounded down.
+    int Seconds(int64_t now_us) const;
+    // Microseconds from now_us until the shown digits change (DurationDigits), -1 if they no longer do
+    int64_t NextChangeUs(int64_t now_us) const;
+
+private:
+    bool countdown_ = false;
+    bool running_ = false;
+    int64_t start_us_ = 0;   // Countdown: end time. Stopwatch: start of the running stretch.
+    int64_t elapsed_us_ = 0; // Stopwatch time before the running stretch; countdown time left when stopped
+};
+
+// Four digits for a duration: MM:SS up to 99:59, HH:MM above, clamped at 99:59 hours
+void DurationDigits(int seconds, int* digits);
+
+#endif // CLOCK_TIMER_H
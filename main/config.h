@@ -4,5 +4,15 @@
 
 #define FIRMWARE_VERSION "Firmware 20250804A  by Jacky "
 #define K1_BUTTON_GPIO          GPIO_NUM_48
+// 双核分工：核 1 只跑时钟任务（模式逻辑、运动规划、I2C 输出）和定时器守护任务，
+// Wi-Fi、lwIP、httpd、DNS 和按键都在核 0，网络突发和网页解析不会抢占舵机帧
+#define MOTION_CORE             1
+#define NETWORK_CORE            0    // Wi-Fi 和 lwIP 的核在 sdkconfig 里固定为 0，DNS 和配网页面同样写死为 0
+#define CLOCK_TASK_PRIORITY     8    // 核 1 上最高的应用任务
+#define HTTPD_TASK_PRIORITY     5
+#define BUTTON_TASK_PRIORITY    10   // 只在按键中断后短暂运行
+#define BENCH_TASK_PRIORITY     2    // /bench 的基准测试在核 0 上低于 httpd 运行，跑几秒也不挡其他请求
+#define PM_MIN_CPU_FREQ_MHZ     40   // 空闲时 CPU 降到晶振频率，运动和网页请求时恢复最高频率
+#define K1_DEBOUNCE_MS          20   // K1 按键中断后等待抖动结束再读电平
 
 #endif
\ No newline at end of file
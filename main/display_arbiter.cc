@@ -0,0 +1,72 @@
+#include "display_arbiter.h"
+
+#include <algorithm>
+
+DisplayArbiter::DisplayArbiter(int schedule_mode) {
+    claims_[DISPLAY_SOURCE_SCHEDULE] = {schedule_mode, DISPLAY_LEASE_NONE};
+    published_.Write(stats_);
+}
+
+void DisplayArbiter::Claim(DisplaySource source, int mode, int64_t until_us) {
+    DisplaySource previous_owner = Owner();
+    claims_[source] = {mode, until_us};
+    held_ |= 1u << source;
+    stats_.claims++;
+    if (source < previous_owner) {
+        stats_.deferred++;
+    }
+    Update(previous_owner);
+}
+
+void DisplayArbiter::Release(DisplaySource source) {
+    if (source == DISPLAY_SOURCE_SCHEDULE) return;
+    DisplaySource previous_owner = Owner();
+    held_ &= ~(1u << source);
+    Update(previous_owner);
+}
+
+void DisplayArbiter::ReleaseRange(DisplaySource low, DisplaySource high) {
+    DisplaySource previous_owner = Owner();
+    uint32_t mask = ((2u << high) - 1) & ~((1u << low) - 1) & ~(1u << DISPLAY_SOURCE_SCHEDULE);
+    held_ &= ~mask;
+    Update(previous_owner);
+}
+
+void DisplayArbiter::Expire(int64_t now_us) {
+    if (now_us < next_expiry_us_) return;
+    DisplaySource previous_owner = Owner();
+    for (int source = 0; source < DISPLAY_SOURCE_NUM; source++) {
+        if (Held((DisplaySource)source) && claims_[source].until_us <= now_us) {
+            held_ &= ~(1u << source);
+            stats_.expired++;
+        }
+    }
+    Update(previous_owner);
+}
+
+// Lease bookkeeping and publishing after held_ changed
+void DisplayArbiter::Update(DisplaySource previous_owner) {
+    next_expiry_us_ = DISPLAY_LEASE_NONE;
+    for (int source = 0; source < DISPLAY_SOURCE_NUM; source++) {
+        if (Held((DisplaySource)source)) {
+            next_expiry_us_ = std::min(next_expiry_us_, claims_[source].until_us);
+        }
+    }
+    if (Owner() != previous_owner) {
+        stats_.handovers++;
+    }
+    stats_.owner = Owner();
+    published_.Write(stats_);
+}
+
+const char* DisplaySourceName(int source) {
+    switch (source) {
+        case DISPLAY_SOURCE_SCHEDULE: return "schedule";
+        case DISPLAY_SOURCE_PAGE: return "page";
+        case DISPLAY_SOURCE_WEB: return "web";
+        case DISPLAY_SOURCE_TIMER: return "timer";
+        case DISPLAY_SOURCE_BUTTON: return "button";
+        case DISPLAY_SOURCE_TEST: return "test";
+        default: return "?";
+    }
+}
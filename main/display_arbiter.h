@@ -0,0 +1,78 @@
+#ifndef DISPLAY_ARBITER_H
+#define DISPLAY_ARBITER_H
+
+#include <stdint.h>
+#include "seqlock.h"
+
+// Decides which source owns the display. Every source holds at most one claim (a mode and
+// an optional lease end); the highest-priority claim that is held wins and the others wait
+// underneath it, so a countdown is not cut by the sleep schedule and a page load does not
+// replace what the user set. When a claim is released or its lease ends, the next one down
+// shows again. The schedule claim is never released: it is the normal clock or the nightly idle.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define DISPLAY_LEASE_NONE INT64_MAX // Held until released
+#define DISPLAY_PAGE_LEASE_S 600     // Page previews (calibration 8888, timer page) give way after this; /adjust renews it
+#define DISPLAY_COUNTDOWN_LINGER_S 10 // A finished countdown keeps 00:00 up this long
+
+// In priority order, lowest first
+enum DisplaySource {
+    DISPLAY_SOURCE_SCHEDULE, // Normal clock, nightly idle
+    DISPLAY_SOURCE_PAGE,     // Web page loads previewing what the page adjusts
+    DISPLAY_SOURCE_WEB,      // Number, text and mode requests from the web API
+    DISPLAY_SOURCE_TIMER,    // Countdown and stopwatch
+    DISPLAY_SOURCE_BUTTON,   // K1 shutdown
+    DISPLAY_SOURCE_TEST,     // Self-benchmark, returns to the others when done
+    DISPLAY_SOURCE_NUM
+};
+
+struct DisplayArbiterStats {
+    uint32_t claims;    // Claims made, the schedule's included
+    uint32_t deferred;  // Claims that did not show because a higher source held the display
+    uint32_t expired;   // Leases that ran out
+    uint32_t handovers; // Times the owner changed
+    int owner;          // DisplaySource showing when published
+};
+
+// Clock task only, except Snapshot(), which reads the stats the clock task published after
+// the last change. Every call is O(1): the held sources are a bit mask and the owner is its
+// highest bit.
+class DisplayArbiter {
+public:
+    explicit DisplayArbiter(int schedule_mode);
+
+    void Claim(DisplaySource source, int mode, int64_t until_us = DISPLAY_LEASE_NONE);
+    void Release(DisplaySource source); // Ignored for the schedule
+    // Release every claim of the sources between low and high, inclusive
+    void ReleaseRange(DisplaySource low, DisplaySource high);
+    // Drop the claims whose lease ended by now_us
+    void Expire(int64_t now_us);
+
+    bool Held(DisplaySource source) const { return (held_ >> source) & 1; }
+    int ClaimedMode(DisplaySource source) const { return claims_[source].mode; }
+    DisplaySource Owner() const { return (DisplaySource)(31 - __builtin_clz(held_)); }
+    int Mode() const { return claims_[Owner()].mode; }
+    // Earliest lease end of a held claim, DISPLAY_LEASE_NONE if none
+    int64_t NextExpiryUs() const { return next_expiry_us_; }
+
+    // Any task: false when every try overlapped a publish
+    bool Snapshot(DisplayArbiterStats& stats) const { return published_.Read(stats); }
+
+private:
+    struct SourceClaim {
+        int mode;
+        int64_t until_us;
+    };
+
+    void Update(DisplaySource previous_owner);
+
+    uint32_t held_ = 1u << DISPLAY_SOURCE_SCHEDULE;
+    SourceClaim claims_[DISPLAY_SOURCE_NUM] = {};
+    int64_t next_expiry_us_ = DISPLAY_LEASE_NONE;
+    DisplayArbiterStats stats_ = {};
+    SeqLock<DisplayArbiterStats> published_;
+};
+
+const char* DisplaySourceName(int source);
+
+#endif // DISPLAY_ARBITER_H
@@ -0,0 +1,61 @@
+#ifndef DISPLAY_FRAME_H
+#define DISPLAY_FRAME_H
+
+#include <stdint.h>
+#include <atomic>
+#include "display_topology.h"
+
+// Desired display frame handed from the mode logic to the motion side. The modes fill the
+// back buffer and publish it with one atomic swap; motion plans from its own front buffer,
+// the latest complete frame, so it never sees glyphs that are still being written.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+struct DisplayFrame {
+    int glyph[CLOCK_DIGIT_NUM];
+    int speed; // SpeedProfileId
+};
+
+// One writer and one reader, triple buffered: writer and reader each own one frame and
+// swap it with the shared middle one, so neither side ever waits for or overwrites the
+// other, however far apart the two run. The clock runs both on the clock task today.
+class DisplayFrameBuffer {
+public:
+    // Writer: the frame to fill, becomes the latest on Publish()
+    DisplayFrame& Back() { return frames_[back_]; }
+
+    void Publish() {
+        back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Reader: copy the latest frame if one was published since the last call
+    bool TakeLatest(DisplayFrame& frame) {
+        if (middle_.load(std::memory_order_relaxed) & kFresh) {
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+            has_front_ = true;
+        } else if (!retake_) {
+            return false;
+        }
+        retake_ = false;
+        frame = frames_[front_];
+        return true;
+    }
+
+    // Reader: the next TakeLatest returns the latest frame again, even without a new Publish().
+    // Nothing to do before the first frame was taken, TakeLatest already returns it.
+    void Retake() {
+        if (has_front_) retake_ = true;
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x03;
+    static constexpr uint8_t kFresh = 0x04; // Middle holds a frame the reader has not taken
+
+    DisplayFrame frames_[3] = {};
+    uint8_t back_ = 0;                // Writer only
+    std::atomic<uint8_t> middle_{1};
+    uint8_t front_ = 2;               // Reader only
+    bool has_front_ = false;          // Reader only
+    bool retake_ = false;             // Reader only
+};
+
+#endif // DISPLAY_FRAME_H
@@ -0,0 +1,58 @@
+#include "display_topology.h"
+
+// 每块驱动板负责两位数字，板上输出 0~7 接第二位的 1~7 段，8~13 接第一位
+#define PWM_TWO_DIGIT_MAP {8, 9, 10, 11, 12, 13, 0, 1, 2, 3, 4, 5, 6, 7}
+
+constexpr DisplayTopology kTopology = {
+#if CLOCK_DIGIT_NUM == 4
+    2,
+    {
+        {0x47, 14, PWM_TWO_DIGIT_MAP}, // Hours
+        {0x41, 14, PWM_TWO_DIGIT_MAP}, // Minutes
+    },
+#elif CLOCK_DIGIT_NUM == 6
+    3,
+    {
+        {0x47, 14, PWM_TWO_DIGIT_MAP}, // Hours
+        {0x41, 14, PWM_TWO_DIGIT_MAP}, // Minutes
+        {0x40, 14, PWM_TWO_DIGIT_MAP}, // Seconds, set to the board's address jumpers
+    },
+#else
+#error "No driver table for this CLOCK_DIGIT_NUM"
+#endif
+};
+
+constexpr int TopologyChannelNum(const DisplayTopology& topology) {
+    int channels = 0;
+    for (int driver = 0; driver < topology.driver_num; driver++) {
+        channels += topology.drivers[driver].channel_num;
+    }
+    return channels;
+}
+
+static_assert(kTopology.driver_num <= MAX_PWM_DRIVERS, "Too many PWM drivers");
+static_assert(TopologyChannelNum(kTopology) == SERVO_CHANNEL_NUM, "Driver channels must cover every servo");
+
+const DisplayTopology kDisplayTopology = kTopology;
+
+bool LookupPwmOutput(int channel, int* driver, int* output) {
+    if (channel < 0) return false;
+    for (int i = 0; i < kDisplayTopology.driver_num; i++) {
+        const PwmDriverConfig& config = kDisplayTopology.drivers[i];
+        if (channel < config.channel_num) {
+            *driver = i;
+            *output = config.output_map[channel];
+            return true;
+        }
+        channel -= config.channel_num;
+    }
+    return false;
+}
+
+int PwmDriverFirstChannel(int driver) {
+    int channel = 0;
+    for (int i = 0; i < driver; i++) {
+        channel += kDisplayTopology.drivers[i].channel_num;
+    }
+    return channel;
+}
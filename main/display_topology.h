@@ -0,0 +1,46 @@
+#ifndef DISPLAY_TOPOLOGY_H
+#define DISPLAY_TOPOLOGY_H
+
+#include <stdint.h>
+
+// Display topology: number of digits, segments per digit and the PCA9685 drivers behind them.
+// Servo channels are numbered digit by digit, left to right (channel = digit * 7 + segment),
+// and are spread over the drivers in table order.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#ifndef CLOCK_DIGIT_NUM
+#define CLOCK_DIGIT_NUM 4          // 4 为 HH:MM，6 为 HH:MM:SS（需要第三块驱动板）
+#endif
+#define SEGMENTS_PER_DIGIT 7
+#define SERVO_CHANNEL_NUM (CLOCK_DIGIT_NUM * SEGMENTS_PER_DIGIT)
+
+#define MAX_PWM_DRIVERS 8          // PCA9685 boards on the bus
+#define PWM_DRIVER_OUTPUTS 16      // Outputs per PCA9685
+
+struct PwmDriverConfig {
+    uint8_t address;                         // I2C address
+    uint8_t channel_num;                     // Servo channels on this driver, following the previous driver's
+    uint8_t output_map[PWM_DRIVER_OUTPUTS];  // PCA9685 output of each of its channels
+};
+
+struct DisplayTopology {
+    int driver_num;
+    PwmDriverConfig drivers[MAX_PWM_DRIVERS];
+};
+
+extern const DisplayTopology kDisplayTopology;
+
+// Driver and output of a servo channel, false if the channel is not wired
+bool LookupPwmOutput(int channel, int* driver, int* output);
+
+// First servo channel of a driver
+int PwmDriverFirstChannel(int driver);
+
+// 舵机状态，按字段分组存放（SoA），每个数组按通道号索引
+struct ServoArrays {
+    int position[SERVO_CHANNEL_NUM]; // 当前位置
+    int target[SERVO_CHANNEL_NUM];   // 目标位置
+    int offset[SERVO_CHANNEL_NUM];   // 每个舵机的偏移量
+};
+
+#endif // DISPLAY_TOPOLOGY_H
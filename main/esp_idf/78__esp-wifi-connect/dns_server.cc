@@ -35,10 +35,11 @@ void DnsServer::Start(esp_ip4_addr_t gateway) {
         return;
     }
 
-    xTaskCreate([](void* arg) {
+    // Core 0 with Wi-Fi and lwIP, core 1 is reserved for the clock
+    xTaskCreatePinnedToCore([](void* arg) {
         DnsServer* dns_server = static_cast<DnsServer*>(arg);
         dns_server->Run();
-    }, "DnsServerTask", 4096, this, 5, NULL);
+    }, "DnsServerTask", 4096, this, 5, NULL, 0);
 }
 
 void DnsServer::Stop() {
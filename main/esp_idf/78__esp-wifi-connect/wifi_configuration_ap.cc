@@ -169,6 +169,7 @@ void WifiConfigurationAp::StartWebServer()
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.max_uri_handlers = 50;
     config.uri_match_fn = httpd_uri_match_wildcard;
+    config.core_id = 0; // With Wi-Fi and lwIP, core 1 is reserved for the clock
     ESP_ERROR_CHECK(httpd_start(&server_, &config));
 
     // Register the index.html file
@@ -18,6 +18,7 @@ const char factory_html[] = R"rawliteral(
         .btn { background: #2675eb; color: #fff; border: none; border-radius: 4px; padding: 7px 20px; font-size: 1em; margin-left: 16px; cursor: pointer; }
         .btn:active { background: #1453b8; }
         .tip { color: #aaa; font-size: 0.95em; margin-top: 16px; text-align: center; }
+        .report { background: #1b1c1f; color: #bfbfbf; font-size: 0.85em; max-height: 240px; overflow: auto; white-space: pre-wrap; word-break: break-all; padding: 8px; border-radius: 4px; }
     </style>
 </head>
 <body>
@@ -34,6 +35,12 @@ const char factory_html[] = R"rawliteral(
             <button class="btn" id="btn-random" onclick="randomMAC()">Random</button>
             <button class="btn" id="btn-default" onclick="defaultMAC()">Default</button>
         </div>
+        <div class="row">
+            <span class="label" id="label-bench">Motion bench:</span>
+            <span class="value" id="bench-status"></span>
+            <button class="btn" id="btn-bench" onclick="runBench()">Run</button>
+        </div>
+        <pre class="report" id="report" style="display:none"></pre>
         <div class="tip" id="tip-area">
             <div id="tip-clear">Click "Clear" to reset UUID .</div>
             <div id="tip-random">Click "Random" to generate and set a new MAC address .</div>
@@ -54,7 +61,11 @@ const char factory_html[] = R"rawliteral(
                 TIP_RANDOM: 'Click "Random" to generate and set a new MAC address .',
                 TIP_DEFAULT: 'Click "Default" to reset MAC address to default .',
                 MAC_ALERT: "MAC address reset to default. Please restart the device for changes to take effect.",
-                MAC_RANDOM_ALERT: "MAC address reset to default. Please restart the device for changes to take effect."
+                MAC_RANDOM_ALERT: "MAC address reset to default. Please restart the device for changes to take effect.",
+                BENCH: "Motion bench:",
+                RUN: "Run",
+                RUNNING: "Running...",
+                DONE: "Done"
             },
             zh: {
                 DEVICE_INFO: "设备信息",
@@ -67,7 +78,11 @@ const char factory_html[] = R"rawliteral(
                 TIP_RANDOM: '点击“随机”可生成并设置新的MAC地址。',
                 TIP_DEFAULT: '点击“恢复默认”可将MAC地址重置为出厂值。',
                 MAC_ALERT: "MAC地址已恢复为默认，请重启设备以生效。",
-                MAC_RANDOM_ALERT: "MAC地址已重置，请重启设备以生效。"
+                MAC_RANDOM_ALERT: "MAC地址已重置，请重启设备以生效。",
+                BENCH: "运动基准:",
+                RUN: "运行",
+                RUNNING: "运行中...",
+                DONE: "完成"
             }
         };
         function getLang() {
@@ -89,6 +104,8 @@ const char factory_html[] = R"rawliteral(
             document.getElementById('tip-clear').textContent = RES.TIP_CLEAR;
             document.getElementById('tip-random').textContent = RES.TIP_RANDOM;
             document.getElementById('tip-default').textContent = RES.TIP_DEFAULT;
+            document.getElementById('label-bench').textContent = RES.BENCH;
+            document.getElementById('btn-bench').textContent = RES.RUN;
         });
 
         function fetchInfo() {
@@ -116,6 +133,28 @@ const char factory_html[] = R"rawliteral(
             fetch('/set?mac=default').then(() => setTimeout(fetchInfo, 500));
             alert(RES.MAC_ALERT);
         }
+        // 显示 JSON 报告，同时提供下载，方便对比不同固件版本
+        function showReport(name, text) {
+            var report = document.getElementById('report');
+            report.style.display = 'block';
+            report.textContent = text;
+            var link = document.createElement('a');
+            link.href = URL.createObjectURL(new Blob([text], {type: 'application/json'}));
+            link.download = name + '.json';
+            link.click();
+        }
+        function runBench() {
+            document.getElementById('bench-status').textContent = RES.RUNNING;
+            fetch('/bench')
+                .then(function(response) { return response.text(); })
+                .then(function(text) {
+                    document.getElementById('bench-status').textContent = RES.DONE;
+                    showReport('motion_bench', text);
+                })
+                .catch(function() {
+                    document.getElementById('bench-status').textContent = '(error)';
+                });
+        }
         window.onload = function() {
             fetchInfo();
         };
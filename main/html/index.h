@@ -253,6 +253,8 @@ const LANG_RES = {
         SETTINGS: "3. Settings",
         SERVO_SILENT: "Servo Silent Mode (Only effective in normal time display mode)",
         HOURS_12: "12 Hours",
+        HOURLY_ANIM: "Hourly animation:",
+        PLAY: "PLAY",
         SLEEP_DURATION: "4. Sleep Duration",
         ENABLE: "Enable:",
         START_TIME: "Start Time:",
@@ -284,6 +286,8 @@ const LANG_RES = {
         SETTINGS: "3. 设置",
         SERVO_SILENT: "舵机静音模式（仅在正常时间显示模式下有效）",
         HOURS_12: "12小时制",
+        HOURLY_ANIM: "整点动画：",
+        PLAY: "播放",
         SLEEP_DURATION: "4. 睡眠时段",
         ENABLE: "启用：",
         START_TIME: "开始时间：",
@@ -323,6 +327,8 @@ window.addEventListener('DOMContentLoaded', function() {
         "title-settings": RES.SETTINGS,
         "span-servosilent": RES.SERVO_SILENT,
         "span-12hours": RES.HOURS_12,
+        "span-hourlyanim": RES.HOURLY_ANIM,
+        "btn-playanim": RES.PLAY,
         "title-sleep": RES.SLEEP_DURATION,
         "span-enable": RES.ENABLE,
         "span-starttime": RES.START_TIME,
@@ -446,6 +452,15 @@ function showPopup(messageKey, closeAfter, bg) {
                 <span id="span-12hours" style="margin-left:10px;">12 Hours</span>
             </div>
         </div>
+        <div class="row">
+            <div class="col-12">
+                <span id="span-hourlyanim">Hourly animation:</span>
+                <select id="hourly_anim" style="width:120px" onchange="set_hourly_anim()">
+                    <option value="none">-</option>
+                </select>
+                <button class="button-primary" id="btn-playanim" onclick="play_anim()">PLAY</button>
+            </div>
+        </div>
         <div class="row">
             <div class="col-12">
                 <h1 id="title-sleep">4. Sleep Duration</h1>
@@ -546,6 +561,18 @@ function set_12hours() {
     send_http(url);
     showToast(RES.SENT_SUCCESS);
 }
+function set_hourly_anim() {
+    send_http("/set?hourly=" + getE('hourly_anim').value);
+    showToast(RES.SENT_SUCCESS);
+}
+function play_anim() {
+    // 未选择整点动画时播放第一个动画
+    var sel = getE('hourly_anim');
+    var name = sel.value != "none" ? sel.value : (sel.options.length > 1 ? sel.options[1].value : "");
+    if (name == "") return;
+    send_http("/set?anim=" + name);
+    showToast(RES.SENT_SUCCESS);
+}
 function set_time_brt(){
     var enable = getE("time_brt_en");
     var h1 = getE("time1_hour").value;
@@ -625,6 +652,12 @@ function getconfig() {
         if(res.t1m !== undefined) getE('time1_minute').value = res.t1m;
         if(res.t2h !== undefined) getE('time2_hour').value = res.t2h;
         if(res.t2m !== undefined) getE('time2_minute').value = res.t2m;
+        if(res.anims !== undefined) {
+            var sel = getE('hourly_anim');
+            sel.length = 1;
+            res.anims.forEach(function(name) { sel.add(new Option(name, name)); });
+            if(res.hourly_anim !== undefined) sel.value = res.hourly_anim;
+        }
     });
 }
 window.onload = function() {
@@ -21,11 +21,12 @@
 #include "esp_wifi.h" 
 #include "ssid_manager.h" 
 #include "esp_sntp.h"
+#include "esp_sleep.h"
+#include "power_manager.h"
 
 
 static const char *TAG = "MAIN";
 
-bool ClockState_ = true;
 
 // I2C bus and PCA9685 handle
 static i2c_master_bus_handle_t bus_handle = nullptr;
@@ -110,6 +111,7 @@ void SetTimezoneOffset(int offset) {
     gettimeofday(&tv, NULL);
     tv.tv_sec = tv.tv_sec - timezone_offset_minute * 60; // Subtract minute offset to avoid repeated accumulation
     ApplyTimezoneAndOffset(&tv, timezone_offset, timezone_offset_minute);
+    CyberClock::GetInstance().TimeChanged(); // Minute boundaries moved
 }
 // Set minute offset
 void SetTimezoneOffsetMinute(int offset) {
@@ -121,15 +123,13 @@ void SetTimezoneOffsetMinute(int offset) {
     Settings settings("cyberclock", true);
     settings.SetInt("mtz", offset);
     ApplyTimezoneAndOffset(&tv, timezone_offset, timezone_offset_minute);
+    CyberClock::GetInstance().TimeChanged(); // Minute boundaries moved
 }
 
 
 void cyberclock_task(void* arg) {
-    // Only reference, no need to assign variable name
-    (void)CyberClock::GetInstance();
-    while (1) {
-        vTaskDelay(pdMS_TO_TICKS(1000));
-    }
+    // Mode logic, motion planning and I2C output all run here, pinned to MOTION_CORE
+    CyberClock::GetInstance().Run();
 }
 
 void Enable_5V_Output(int enable) {
@@ -149,21 +149,45 @@ void Enable_5V_Output(int enable) {
 void InitButtons() {
     // Initialize K1 button GPIO
     gpio_config_t io_conf = {};
-    io_conf.intr_type = GPIO_INTR_DISABLE; // Disable interrupt
+    io_conf.intr_type = GPIO_INTR_DISABLE; // K1_ButtonTask arms a level interrupt
     io_conf.mode = GPIO_MODE_INPUT; // Set as input mode
     io_conf.pin_bit_mask = (1ULL << K1_BUTTON_GPIO); // Set K1 button GPIO
     io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE; // Disable pull-down
     io_conf.pull_up_en = GPIO_PULLUP_ENABLE; // Enable pull-up
     ESP_ERROR_CHECK(gpio_config(&io_conf)); // Configure K1 button GPIO
+    ESP_ERROR_CHECK(gpio_install_isr_service(0));
+    // Edge interrupts do not wake the chip from light sleep, level ones do
+    ESP_ERROR_CHECK(esp_sleep_enable_gpio_wakeup());
 
     ESP_LOGI(TAG, "Buttons initialized on K1_BUTTON_GPIO");
 }
 
+// Button level changed: mask the level interrupt and wake the button task, which debounces,
+// reads the level and arms the interrupt for the opposite level
+static void K1_ButtonIsr(void* arg) {
+    BaseType_t woken = pdFALSE;
+    gpio_intr_disable(K1_BUTTON_GPIO);
+    vTaskNotifyGiveFromISR((TaskHandle_t)arg, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Interrupt and light-sleep wakeup when the button leaves level
+static void K1_ArmButton(int level) {
+    gpio_wakeup_enable(K1_BUTTON_GPIO, level ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    gpio_intr_enable(K1_BUTTON_GPIO);
+}
+
 void K1_ButtonTask(void*) {
     int last_level = 1;
     int press_time = 0;
+    gpio_isr_handler_add(K1_BUTTON_GPIO, K1_ButtonIsr, xTaskGetCurrentTaskHandle());
+    K1_ArmButton(last_level);
     while (1) {
+        // Sleep until the button changes instead of polling it
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(pdMS_TO_TICKS(K1_DEBOUNCE_MS));
         int level = gpio_get_level(K1_BUTTON_GPIO);
+        K1_ArmButton(level);
         if (last_level == 1 && level == 0) { // Pressed
             press_time = esp_timer_get_time();
         }
@@ -178,20 +202,11 @@ void K1_ButtonTask(void*) {
                 vTaskDelay(pdMS_TO_TICKS(500)); // Wait for operation to complete
                 esp_restart(); // Restart board
             } else if (duration > 20) {
-                // Single click
-                if (ClockState_) {
-                    ESP_LOGI(TAG, "K1 Click,Clock is shutting down...");
-                    CyberClock::GetInstance().ShutdownClock();
-                    ClockState_ = false;
-                } else {
-                    ESP_LOGI(TAG, "K1 Click,Clock is 8888");
-                    CyberClock::GetInstance().SetNumber(8,8,8,8);
-                    ClockState_ = true;
-                }
+                // Single click: shut down, or hand the display back
+                CyberClock::GetInstance().ButtonClick();
             }
         }
         last_level = level;
-        vTaskDelay(pdMS_TO_TICKS(10));
     }
 }
 
@@ -237,6 +252,7 @@ void SyncTime()
 
     // Give the semaphore to indicate time is ready
     xSemaphoreGive(server_time_ready_semaphore);
+    CyberClock::GetInstance().TimeChanged(); // Show the time now instead of waiting for a deadline
 }
 
 extern "C" void app_main(void)
@@ -246,12 +262,13 @@ extern "C" void app_main(void)
     InitButtons(); // Initialize buttons
     Enable_5V_Output(1); // Enable 5V output for servos
     InitNVS(); // Initialize NVS (non-volatile storage)
+    PowerManager::GetInstance().Init(); // Frequency scaling and light sleep, before any PM lock is taken
     //InitCodec(); // Initialize Codec using ES8311AudioCodec class
 
-    xTaskCreate(cyberclock_task, "cyberclock_task", 8192, NULL, 5, NULL);
+    xTaskCreatePinnedToCore(cyberclock_task, "cyberclock_task", 8192, NULL, CLOCK_TASK_PRIORITY, NULL, MOTION_CORE);
 
     // Create K1 button detection task
-    xTaskCreate(K1_ButtonTask, "K1_ButtonTask", 4096, NULL, 10, NULL);
+    xTaskCreatePinnedToCore(K1_ButtonTask, "K1_ButtonTask", 4096, NULL, BUTTON_TASK_PRIORITY, NULL, NETWORK_CORE);
 
     // New WiFi/network initialization, managed by wifi_board
     WifiBoard& wifi_board = WifiBoard::GetInstance();
@@ -259,7 +276,5 @@ extern "C" void app_main(void)
 
     StartWebServer(); // Start WebServer, ensure network is ready
 
-    while (1) {
-        vTaskDelay(pdMS_TO_TICKS(1000));
-    }
+    // Returning deletes the main task; everything runs on its own tasks and timers
 }
@@ -7,7 +7,6 @@
 extern "C" {
 #endif
 
-extern bool ClockState_; // 时钟状态，true表示运行中，false表示已关闭
 void SyncTime();
 void SetTimezoneOffset(int offset);
 void SetTimezoneOffsetMinute(int offset);
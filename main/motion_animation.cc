@@ -0,0 +1,237 @@
+#include "motion_animation.h"
+
+#include <string.h>
+#include <algorithm>
+
+#define EASE_TABLE_BITS 6                               // 64 segments per curve
+#define EASE_TABLE_SIZE (1 << EASE_TABLE_BITS)
+#define EASE_SEGMENT_SHIFT (15 - EASE_TABLE_BITS)       // Q15 progress bits inside one segment
+#define EASE_CURVE_NUM ANIM_EASE_STEP                   // Curves with a table, STEP needs none
+
+// 所有动画先把指针收到灭位：先收 0~5 段，再收中间段，这样中间段扫过时不会碰到 1、5 段
+#define ANIM_CLEAR_KEYFRAMES \
+    {ANIM_ALL_DIGITS, ANIM_ALL_SEGMENTS & ~AnimSegment(6), 0, 300, 0, ANIM_EASE_IN_OUT}, \
+    {ANIM_ALL_DIGITS, AnimSegment(6), 0, 500, 0, ANIM_EASE_IN_OUT}
+
+// Outer segments light up digit by digit, then go out in the same order
+static const AnimKeyframe kWaveKeyframes[] = {
+    ANIM_CLEAR_KEYFRAMES,
+    {AnimDigit(0), 0x3F, ANIM_ALL_SEGMENTS, 650, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {AnimDigit(1), 0x3F, ANIM_ALL_SEGMENTS, 800, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {AnimDigit(2), 0x3F, ANIM_ALL_SEGMENTS, 950, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {AnimDigit(3), 0x3F, ANIM_ALL_SEGMENTS, 1100, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {AnimDigit(0), 0x3F, 0, 1250, 0, ANIM_EASE_IN},
+    {AnimDigit(1), 0x3F, 0, 1400, 0, ANIM_EASE_IN},
+    {AnimDigit(2), 0x3F, 0, 1550, 0, ANIM_EASE_IN},
+    {AnimDigit(3), 0x3F, 0, 1700, 0, ANIM_EASE_IN},
+};
+
+// A curtain falling from the top segment to the bottom one, then lifting again.
+// The middle segment moves only while segments 1 and 5 are off.
+static const AnimKeyframe kCascadeKeyframes[] = {
+    ANIM_CLEAR_KEYFRAMES,
+    {ANIM_ALL_DIGITS, AnimSegment(0), ANIM_ALL_SEGMENTS, 600, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {ANIM_ALL_DIGITS, AnimSegment(6), ANIM_ALL_SEGMENTS, 750, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {ANIM_ALL_DIGITS, AnimSegment(1) | AnimSegment(5), ANIM_ALL_SEGMENTS, 900, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {ANIM_ALL_DIGITS, AnimSegment(2) | AnimSegment(4), ANIM_ALL_SEGMENTS, 1050, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {ANIM_ALL_DIGITS, AnimSegment(3), ANIM_ALL_SEGMENTS, 1200, ANIM_LEVEL_ON, ANIM_EASE_OUT},
+    {ANIM_ALL_DIGITS, AnimSegment(0), 0, 1500, 0, ANIM_EASE_IN},
+    {ANIM_ALL_DIGITS, AnimSegment(1) | AnimSegment(5), 0, 1650, 0, ANIM_EASE_IN},
+    {ANIM_ALL_DIGITS, AnimSegment(6), 0, 1800, 0, ANIM_EASE_IN},
+    {ANIM_ALL_DIGITS, AnimSegment(2) | AnimSegment(4), 0, 1950, 0, ANIM_EASE_IN},
+    {ANIM_ALL_DIGITS, AnimSegment(3), 0, 2100, 0, ANIM_EASE_IN},
+};
+
+// One lit segment runs twice around the outside of every digit
+static const AnimKeyframe kSpinKeyframes[] = {
+    ANIM_CLEAR_KEYFRAMES,
+    {ANIM_ALL_DIGITS, AnimSegment(0), AnimSegment(0), 600, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(0) | AnimSegment(1), AnimSegment(1), 700, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(1) | AnimSegment(2), AnimSegment(2), 800, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(2) | AnimSegment(3), AnimSegment(3), 900, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(3) | AnimSegment(4), AnimSegment(4), 1000, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(4) | AnimSegment(5), AnimSegment(5), 1100, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(5) | AnimSegment(0), AnimSegment(0), 1200, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(0) | AnimSegment(1), AnimSegment(1), 1300, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(1) | AnimSegment(2), AnimSegment(2), 1400, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(2) | AnimSegment(3), AnimSegment(3), 1500, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(3) | AnimSegment(4), AnimSegment(4), 1600, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(4) | AnimSegment(5), AnimSegment(5), 1700, ANIM_LEVEL_ON, ANIM_EASE_LINEAR},
+    {ANIM_ALL_DIGITS, AnimSegment(5), 0, 1850, 0, ANIM_EASE_IN},
+};
+
+#define ANIM_KEYFRAME_NUM(keyframes) ((int)(sizeof(keyframes) / sizeof(keyframes[0])))
+
+const Animation kAnimations[] = {
+    {"wave", kWaveKeyframes, ANIM_KEYFRAME_NUM(kWaveKeyframes)},
+    {"cascade", kCascadeKeyframes, ANIM_KEYFRAME_NUM(kCascadeKeyframes)},
+    {"spin", kSpinKeyframes, ANIM_KEYFRAME_NUM(kSpinKeyframes)},
+};
+
+const int kAnimationNum = sizeof(kAnimations) / sizeof(kAnimations[0]);
+
+const Animation* FindAnimation(const char* name) {
+    for (int i = 0; i < kAnimationNum; i++) {
+        if (strcmp(kAnimations[i].name, name) == 0) {
+            return &kAnimations[i];
+        }
+    }
+    return nullptr;
+}
+
+namespace {
+
+// Depth of a channel: 0 at its on position, positive towards off (see ArmConflict)
+int Depth(const ServoProfile& profile, const int* offsets, int ch, int position) {
+    int on = profile.OnPosition(ch) + offsets[ch];
+    int dir = (profile.OffPosition(ch) > profile.OnPosition(ch)) ? 1 : -1;
+    return (position - on) * dir;
+}
+
+// Every arm moves in a straight line from from[] to to[]. A collision is possible when a
+// mover passes through its sweep range while the blocker is shallower than block_depth at
+// either end; the blocker moves monotonically, so its shallowest point is one of the ends.
+bool IntervalCollides(const ServoProfile& profile, const int* offsets, const int16_t* from, const int16_t* to) {
+    for (int base_channel = 0; base_channel < SERVO_CHANNEL_NUM; base_channel += SEGMENTS_PER_DIGIT) {
+        for (int k = 0; k < profile.conflict_num; k++) {
+            const ArmConflict& conflict = profile.conflicts[k];
+            int m_ch = base_channel + conflict.mover;
+            int b_ch = base_channel + conflict.blocker;
+            int m_from = Depth(profile, offsets, m_ch, from[m_ch]);
+            int m_to = Depth(profile, offsets, m_ch, to[m_ch]);
+            if (std::max(m_from, m_to) < conflict.sweep_lo || std::min(m_from, m_to) > conflict.sweep_hi) continue;
+
+            int b_depth = std::min(Depth(profile, offsets, b_ch, from[b_ch]), Depth(profile, offsets, b_ch, to[b_ch]));
+            if (b_depth < conflict.block_depth) return true;
+        }
+    }
+    return false;
+}
+
+// Exact curve at Q15 progress x, only evaluated at compile time to fill the tables
+constexpr int EaseCurve(int easing, int x) {
+    int rest = MOTION_Q15_ONE - x;
+    switch (easing) {
+        case ANIM_EASE_IN:
+            return (int)((int64_t)x * x >> 15);
+        case ANIM_EASE_OUT:
+            return MOTION_Q15_ONE - (int)((int64_t)rest * rest >> 15);
+        case ANIM_EASE_IN_OUT:
+            return (x < MOTION_Q15_ONE / 2) ? (int)(2 * (int64_t)x * x >> 15)
+                                            : MOTION_Q15_ONE - (int)(2 * (int64_t)rest * rest >> 15);
+        default:
+            return x;
+    }
+}
+
+struct EaseTable {
+    uint16_t value[EASE_CURVE_NUM][EASE_TABLE_SIZE + 1];
+};
+
+constexpr EaseTable MakeEaseTable() {
+    EaseTable table = {};
+    for (int easing = 0; easing < EASE_CURVE_NUM; easing++) {
+        for (int i = 0; i <= EASE_TABLE_SIZE; i++) {
+            table.value[easing][i] = EaseCurve(easing, i << EASE_SEGMENT_SHIFT);
+        }
+    }
+    return table;
+}
+
+constexpr EaseTable kEaseTable = MakeEaseTable();
+
+} // namespace
+
+int AnimEaseQ15(int easing, int progress) {
+    if (progress >= MOTION_Q15_ONE) return MOTION_Q15_ONE;
+    if (easing == ANIM_EASE_STEP) return 0;
+    if (easing > ANIM_EASE_STEP) easing = ANIM_EASE_LINEAR;
+
+    const uint16_t* curve = kEaseTable.value[easing];
+    int index = progress >> EASE_SEGMENT_SHIFT;
+    int part = progress & ((1 << EASE_SEGMENT_SHIFT) - 1);
+    return curve[index] + (((curve[index + 1] - curve[index]) * part) >> EASE_SEGMENT_SHIFT);
+}
+
+void AnimationPlayer::Pose(int key, const int16_t* from, int16_t* to) const {
+    const AnimKeyframe& keyframe = anim_->keyframes[key];
+    for (int ch = 0; ch < SERVO_CHANNEL_NUM; ch++) {
+        int seg = ch % SEGMENTS_PER_DIGIT;
+        uint32_t seg_bit = 1u << seg;
+        if (!(keyframe.digits & (1u << (ch / SEGMENTS_PER_DIGIT))) || !(keyframe.move_segments & seg_bit)) {
+            to[ch] = from[ch];
+            continue;
+        }
+        int off = profile_->segment_off[seg] + offsets_[ch];
+        int on = profile_->segment_on[seg] + offsets_[ch];
+        int position = (keyframe.on_segments & seg_bit) ? off + (on - off) * keyframe.level / ANIM_LEVEL_ON : off;
+        to[ch] = std::clamp(position, SERVO_POSITION_MIN, SERVO_POSITION_MAX);
+    }
+}
+
+int AnimationPlayer::Start(const Animation& anim, const ServoProfile& profile, const int* offsets, const int* start) {
+    anim_ = &anim;
+    profile_ = &profile;
+    offsets_ = offsets;
+    key_ = 0;
+    from_ms_ = 0;
+    std::copy(start, start + SERVO_CHANNEL_NUM, from_);
+    std::copy(start, start + SERVO_CHANNEL_NUM, to_);
+
+    // Walk the whole timeline once before the first frame
+    int16_t pose[SERVO_CHANNEL_NUM];
+    int16_t next[SERVO_CHANNEL_NUM];
+    std::copy(start, start + SERVO_CHANNEL_NUM, pose);
+    for (int k = 0; k < anim.keyframe_num; k++) {
+        Pose(k, pose, next);
+        if (IntervalCollides(profile, offsets, pose, next)) return k;
+        std::copy(next, next + SERVO_CHANNEL_NUM, pose);
+    }
+
+    if (anim.keyframe_num > 0) {
+        Pose(0, from_, to_);
+        BeginInterval();
+    }
+    return -1;
+}
+
+// The one division of an interval, every frame inside it only multiplies and shifts
+void AnimationPlayer::BeginInterval() {
+    int duration = anim_->keyframes[key_].time_ms - from_ms_;
+    inv_duration_q24_ = (duration > 0) ? (1 << 24) / duration : 0;
+}
+
+int AnimationPlayer::FrameNum() const {
+    if (anim_ == nullptr || anim_->keyframe_num == 0) return 0;
+    int last_ms = anim_->keyframes[anim_->keyframe_num - 1].time_ms;
+    return (last_ms + ANIM_FRAME_MS - 1) / ANIM_FRAME_MS + 1;
+}
+
+void AnimationPlayer::Sample(int frame, int* positions) {
+    const int time_ms = frame * ANIM_FRAME_MS;
+    const int keyframe_num = anim_->keyframe_num;
+
+    // Pass every keyframe that is due, the pose reached there starts the next interval
+    while (key_ < keyframe_num && time_ms >= anim_->keyframes[key_].time_ms) {
+        from_ms_ = anim_->keyframes[key_].time_ms;
+        std::copy(to_, to_ + SERVO_CHANNEL_NUM, from_);
+        key_++;
+        if (key_ < keyframe_num) {
+            Pose(key_, from_, to_);
+            BeginInterval();
+        }
+    }
+
+    if (key_ >= keyframe_num) {
+        std::copy(from_, from_ + SERVO_CHANNEL_NUM, positions);
+        return;
+    }
+
+    // All channels at once in the vector kernel, every pose is already within the servo range
+    // elapsed < duration <= 65535 ms, so elapsed * 2^24 / duration stays below 2^24
+    const AnimKeyframe& keyframe = anim_->keyframes[key_];
+    int progress = (inv_duration_q24_ > 0) ? ((time_ms - from_ms_) * inv_duration_q24_) >> 9 : MOTION_Q15_ONE;
+    int fraction = AnimEaseQ15(keyframe.easing, progress);
+    InterpolatePositions(from_, to_, fraction, SERVO_POSITION_MIN, SERVO_POSITION_MAX, frame_, SERVO_LANE_NUM);
+    std::copy(frame_, frame_ + SERVO_CHANNEL_NUM, positions);
+}
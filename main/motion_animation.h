@@ -0,0 +1,97 @@
+#ifndef MOTION_ANIMATION_H
+#define MOTION_ANIMATION_H
+
+#include <stdint.h>
+#include "motion_engine.h"
+#include "motion_planner.h"
+#include "motion_kernel.h"
+
+// Keyframe animations (cascades, waves, hourly flourishes) played frame by frame.
+// Timelines are const tables kept in flash; playback works on fixed arrays and never allocates.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define ANIM_FRAME_MS 20        // One frame per PWM period (50 Hz)
+#define ANIM_LEVEL_ON 255       // Keyframe level of the on position, 0 is the off position
+#define ANIM_ALL_SEGMENTS 0x7F  // Segments 0..6
+#define ANIM_ALL_DIGITS ((1u << CLOCK_DIGIT_NUM) - 1)
+
+static_assert(CLOCK_DIGIT_NUM <= 16, "Keyframe digit masks hold 16 digits");
+
+// Easing used to reach a keyframe from the previous one
+enum AnimEasing : uint8_t {
+    ANIM_EASE_LINEAR,
+    ANIM_EASE_IN,     // Slow start
+    ANIM_EASE_OUT,    // Slow end
+    ANIM_EASE_IN_OUT,
+    ANIM_EASE_STEP,   // Hold, then jump at the keyframe time
+};
+
+// Eased fraction (Q15) after progress (Q15, 0..MOTION_Q15_ONE) of the way to a keyframe.
+// Table lookup with linear interpolation between entries, no division.
+int AnimEaseQ15(int easing, int progress);
+
+// 关键帧：digits 中每一位（bit = 数字位 0~15，从左到右）的 move_segments 段（bit = 段号 0~6）
+// 移动到新位置，其余舵机保持不动。on_segments 中的段移到 level 位置（0 为灭位，255 为亮位），
+// 其余移到灭位。8 字节一帧，与位数无关。
+struct AnimKeyframe {
+    uint16_t digits;       // Digits this keyframe moves
+    uint8_t move_segments; // Segments it moves in each of them
+    uint8_t on_segments;   // Moved segments that go to level, the others go off
+    uint16_t time_ms;      // Time from the start of the animation
+    uint8_t level;         // Position between off (0) and on (ANIM_LEVEL_ON)
+    uint8_t easing;        // AnimEasing from the previous keyframe
+};
+
+struct Animation {
+    const char* name;
+    const AnimKeyframe* keyframes; // Sorted by time_ms
+    int keyframe_num;
+};
+
+// Segment mask of segment seg (0..6)
+constexpr uint8_t AnimSegment(int seg) {
+    return 1u << seg;
+}
+
+// Digit mask of one digit (0 is the leftmost)
+constexpr uint16_t AnimDigit(int digit) {
+    return 1u << digit;
+}
+
+extern const Animation kAnimations[];
+extern const int kAnimationNum;
+
+// Built-in animation by name, nullptr if there is none
+const Animation* FindAnimation(const char* name);
+
+// Interpolates a timeline into one set of positions per frame
+class AnimationPlayer {
+public:
+    // Prepare anim to start from start[SERVO_CHANNEL_NUM]. Every keyframe interval is checked against the
+    // profile's conflict model; returns the first keyframe that would make two arms
+    // collide (the animation must not be played), or -1 when the timeline is safe.
+    int Start(const Animation& anim, const ServoProfile& profile, const int* offsets, const int* start);
+
+    // Frames from time 0 up to and including the last keyframe
+    int FrameNum() const;
+
+    // Positions of frame (ANIM_FRAME_MS apart). Frames may be skipped but not replayed.
+    void Sample(int frame, int* positions);
+
+private:
+    void Pose(int key, const int16_t* from, int16_t* to) const;
+    void BeginInterval();
+
+    const Animation* anim_ = nullptr;
+    const ServoProfile* profile_ = nullptr;
+    const int* offsets_ = nullptr;
+    int key_ = 0;                     // Keyframe being approached
+    int from_ms_ = 0;                 // Time of the previous keyframe
+    int inv_duration_q24_ = 0;        // 2^24 / ms from the previous keyframe to key_, 0 when it takes no time
+    // Kernel lanes, padded to whole vectors
+    alignas(MOTION_LANE_ALIGN) int16_t from_[SERVO_LANE_NUM] = {};  // Pose at the previous keyframe
+    alignas(MOTION_LANE_ALIGN) int16_t to_[SERVO_LANE_NUM] = {};    // Pose at keyframe key_
+    alignas(MOTION_LANE_ALIGN) int16_t frame_[SERVO_LANE_NUM] = {}; // Last sampled frame
+};
+
+#endif // MOTION_ANIMATION_H
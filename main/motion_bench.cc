@@ -0,0 +1,558 @@
+#include "motion_bench.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "motion_engine.h"
+#include "motion_kernel.h"
+#include "motion_animation.h"
+#include "motion_planner.h"
+#include "motion_corpus.h"
+#include "motion_trace.h"
+
+#define BENCH_I2C_WRITES_PER_PWM 1 // SetPWM writes LEDn_ON_L..LEDn_OFF_H in one auto-increment burst
+#define BENCH_HIST_BUCKETS 20      // log2 buckets of completion time in ms
+#define BENCH_WORST_NUM 5
+#define CORPUS_DIFF_NUM 20         // Transitions listed per category in the corpus report
+#define CORPUS_REST_GLYPH 8        // Glyph held by the digits that do not change
+#define KERNEL_BENCH_FRAMES 4096   // Frames timed per channel count
+#define KERNEL_BENCH_LANES (MAX_PWM_DRIVERS * PWM_DRIVER_OUTPUTS) // Largest topology
+
+namespace {
+
+struct Frame {
+    int glyph[CLOCK_DIGIT_NUM];
+};
+
+struct TransitionResult : MotionSimResult {
+    Frame from;
+    Frame to;
+};
+
+class CountingOutput : public MotionOutput {
+public:
+    void WriteChannel(int, int) override { writes++; }
+    int writes = 0;
+};
+
+void AppendF(std::string& out, const char* fmt, ...) {
+    char buf[160];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (len > 0) {
+        out.append(buf, std::min(len, (int)sizeof(buf) - 1));
+    }
+}
+
+void AppendFrame(std::string& out, const Frame& frame) {
+    static const char glyph_chars[GLYPH_NUM + 1] = "0123456789_-"; // 0xA 全关, 0xB idle
+    out += "\"";
+    for (int digit = 0; digit < CLOCK_DIGIT_NUM; digit++) {
+        if (digit > 0 && digit % 2 == 0) out += ":";
+        out += glyph_chars[frame.glyph[digit]];
+    }
+    out += "\"";
+}
+
+// Every digit shows glyph
+Frame UniformFrame(int glyph) {
+    Frame frame;
+    std::fill(frame.glyph, frame.glyph + CLOCK_DIGIT_NUM, glyph);
+    return frame;
+}
+
+// hh:mm, digits after the fourth (seconds) show 0
+Frame ClockFrame(int hour, int minute) {
+    Frame frame = UniformFrame(0);
+    frame.glyph[0] = hour / 10;
+    frame.glyph[1] = hour % 10;
+    frame.glyph[2] = minute / 10;
+    frame.glyph[3] = minute % 10;
+    return frame;
+}
+
+// Same conversion as the 12 hour display in OnTimerTick
+int To12Hour(int hour) {
+    if (hour > 12) return hour - 12;
+    if (hour == 0) return 12;
+    return hour;
+}
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const MotionBenchConfig& config)
+        : config_(config), profile_(kServoProfiles[config.servo_profile == SERVO_PROFILE_B ? 1 : 0]) {}
+
+    // Put the servos at the resting positions of frame without moving them
+    void Settle(const Frame& frame) {
+        GetGlyphTargets(profile_, offsets_, frame.glyph, current_);
+        frame_ = frame;
+    }
+
+    // Plan and execute one transition the same way TaskUpdateDisplay and ExecuteTask do
+    TransitionResult Transition(const Frame& to) {
+        std::vector<ServoState> plan;
+        int target[SERVO_CHANNEL_NUM];
+        PlanDisplayTransition(profile_, offsets_, current_, to.glyph, kSpeedProfiles[config_.speed].step, target, plan);
+        if (config_.optimize_order) {
+            OptimizeMoveOrder(plan, MOTION_POOL_BENCH);
+        }
+
+        TransitionResult result;
+        static_cast<MotionSimResult&>(result) = SimulatePlan(plan, current_, config_.i2c_transaction_us);
+        result.from = frame_;
+        result.to = to;
+        frame_ = to;
+        return result;
+    }
+
+private:
+    const MotionBenchConfig& config_;
+    const ServoProfile& profile_;
+    int offsets_[SERVO_CHANNEL_NUM] = {0}; // Nominal calibration, so results compare across units
+    int current_[SERVO_CHANNEL_NUM] = {0};
+    Frame frame_ = {};
+};
+
+void AppendSuite(std::string& json, const char* name, std::vector<TransitionResult>& results) {
+    int64_t total_us = 0;
+    int64_t total_moves = 0, total_avoid = 0, total_i2c = 0, total_rounds = 0, total_dropped = 0;
+    int max_moves = 0, max_avoid = 0, max_i2c = 0;
+    int hist[BENCH_HIST_BUCKETS] = {0};
+    std::vector<int64_t> times;
+    times.reserve(results.size());
+
+    for (const auto& r : results) {
+        total_us += r.time_us;
+        total_moves += r.moves;
+        total_avoid += r.avoid_moves;
+        total_i2c += r.i2c_transactions;
+        total_rounds += r.rounds;
+        total_dropped += r.dropped;
+        max_moves = std::max(max_moves, r.moves);
+        max_avoid = std::max(max_avoid, r.avoid_moves);
+        max_i2c = std::max(max_i2c, r.i2c_transactions);
+        times.push_back(r.time_us);
+
+        // Bucket n counts transitions taking [2^(n-1), 2^n) ms
+        int64_t ms = r.time_us / 1000;
+        int bucket = 0;
+        while (ms > 0 && bucket < BENCH_HIST_BUCKETS - 1) {
+            ms >>= 1;
+            bucket++;
+        }
+        hist[bucket]++;
+    }
+    std::sort(times.begin(), times.end());
+
+    size_t n = results.size();
+    auto Percentile = [&](int p) -> double {
+        return n ? times[(n - 1) * p / 100] / 1000.0 : 0.0;
+    };
+
+    AppendF(json, "{\"name\":\"%s\",\"transitions\":%u,", name, (unsigned)n);
+    AppendF(json, "\"time_ms\":{\"min\":%.1f,\"p50\":%.1f,\"p90\":%.1f,\"p99\":%.1f,\"max\":%.1f,",
+            Percentile(0), Percentile(50), Percentile(90), Percentile(99), Percentile(100));
+    AppendF(json, "\"mean\":%.1f,\"total\":%.1f},", n ? total_us / 1000.0 / n : 0.0, total_us / 1000.0);
+    json += "\"hist_log2_ms\":[";
+    for (int i = 0; i < BENCH_HIST_BUCKETS; i++) {
+        AppendF(json, i ? ",%d" : "%d", hist[i]);
+    }
+    json += "],";
+    AppendF(json, "\"moves\":{\"total\":%lld,\"max\":%d},", (long long)total_moves, max_moves);
+    AppendF(json, "\"avoid_moves\":{\"total\":%lld,\"max\":%d},", (long long)total_avoid, max_avoid);
+    AppendF(json, "\"i2c\":{\"total\":%lld,\"max\":%d},", (long long)total_i2c, max_i2c);
+    AppendF(json, "\"rounds\":%lld,\"dropped\":%lld,", (long long)total_rounds, (long long)total_dropped);
+
+    // Slowest transitions, so regressions can be traced back to a glyph pair. A pair that
+    // recurs (the 12 hour suite shows every hour twice a day) is listed once with its count.
+    std::stable_sort(results.begin(), results.end(), [](const TransitionResult& x, const TransitionResult& y) {
+        return x.time_us > y.time_us;
+    });
+    auto SamePair = [](const TransitionResult& x, const TransitionResult& y) {
+        return std::equal(x.from.glyph, x.from.glyph + CLOCK_DIGIT_NUM, y.from.glyph) &&
+               std::equal(x.to.glyph, x.to.glyph + CLOCK_DIGIT_NUM, y.to.glyph);
+    };
+    std::vector<const TransitionResult*> worst;
+    for (size_t i = 0; i < results.size() && worst.size() < BENCH_WORST_NUM; i++) {
+        bool listed = std::any_of(worst.begin(), worst.end(), [&](const TransitionResult* w) { return SamePair(*w, results[i]); });
+        if (!listed) worst.push_back(&results[i]);
+    }
+    json += "\"worst\":[";
+    for (size_t i = 0; i < worst.size(); i++) {
+        const TransitionResult& r = *worst[i];
+        int count = std::count_if(results.begin(), results.end(), [&](const TransitionResult& x) { return SamePair(x, r); });
+        json += i ? ",{\"from\":" : "{\"from\":";
+        AppendFrame(json, r.from);
+        json += ",\"to\":";
+        AppendFrame(json, r.to);
+        AppendF(json, ",\"ms\":%.1f,\"moves\":%d,\"count\":%d}", r.time_us / 1000.0, r.moves, count);
+    }
+    json += "]}";
+}
+
+// Settle on frames[0], then run each following frame as one transition
+void RunSuite(const MotionBenchConfig& config, std::string& json, const char* name, const std::vector<Frame>& frames) {
+    BenchRunner runner(config);
+    std::vector<TransitionResult> results;
+    results.reserve(frames.size());
+    runner.Settle(frames[0]);
+    for (size_t i = 1; i < frames.size(); i++) {
+        results.push_back(runner.Transition(frames[i]));
+    }
+    AppendSuite(json, name, results);
+}
+
+} // namespace
+
+MotionSimResult SimulatePlan(const std::vector<ServoState>& plan, int* current, int i2c_transaction_us) {
+    MotionSimResult result;
+    MotionEngine engine(MOTION_POOL_BENCH);
+    for (const auto& task : plan) {
+        if (!engine.AddTask(task)) {
+            // Like the clock: moves behind a dropped one would start early, none of the plan runs
+            engine.Clear();
+            result.dropped = plan.size();
+            result.moves = 0;
+            result.avoid_moves = 0;
+            return result;
+        }
+        result.moves++;
+        if (task.avoidance) result.avoid_moves++;
+    }
+
+    const int64_t write_us = SERVO_STEP_DELAY_MS * 1000 + BENCH_I2C_WRITES_PER_PWM * i2c_transaction_us;
+    bool tasks_remaining = true;
+    while (tasks_remaining) {
+        CountingOutput output;
+        MotionRound round = engine.RunRound(current, output);
+        tasks_remaining = round.tasks_remaining;
+        result.rounds++;
+        result.time_us += output.writes * write_us;
+        result.i2c_transactions += output.writes * BENCH_I2C_WRITES_PER_PWM;
+        if (round.restart) continue;
+        result.time_us += SERVO_STEP_DELAY_MS * 1000;
+    }
+    return result;
+}
+
+void RunMotionBenchmark(const MotionBenchConfig& config, std::string& json) {
+    const ServoProfile& profile = kServoProfiles[config.servo_profile == SERVO_PROFILE_B ? 1 : 0];
+    AppendF(json, "{\"bench\":\"motion\",\"version\":2,\"profile\":\"%s\",\"speed\":\"%s\",\"step\":%d,\"optimize_order\":%s,",
+            profile.name, kSpeedProfiles[config.speed].name, kSpeedProfiles[config.speed].step,
+            config.optimize_order ? "true" : "false");
+    AppendF(json, "\"i2c_us\":%d,\"step_delay_ms\":%d,\"max_tasks\":%d,\"suites\":[",
+            config.i2c_transaction_us, SERVO_STEP_DELAY_MS, MAX_SERVO_TASK_NUM);
+
+    std::vector<Frame> frames;
+    frames.reserve(24 * 60 + 1);
+
+    // Every minute change of a day, 24 hour display
+    for (int minute = 0; minute <= 24 * 60; minute++) {
+        frames.push_back(ClockFrame((minute / 60) % 24, minute % 60));
+    }
+    RunSuite(config, json, "clock_24h", frames);
+    json += ",";
+
+    // Every minute change of a day, 12 hour display
+    frames.clear();
+    for (int minute = 0; minute <= 24 * 60; minute++) {
+        frames.push_back(ClockFrame(To12Hour((minute / 60) % 24), minute % 60));
+    }
+    RunSuite(config, json, "clock_12h", frames);
+    json += ",";
+
+    // 8888 -> all off -> 8888
+    const Frame all_on = UniformFrame(8);
+    const Frame all_off = UniformFrame(GLYPH_OFF);
+    RunSuite(config, json, "full_off", {all_on, all_off, all_on});
+    json += ",";
+
+    // Idle <-> every full hour
+    const Frame idle = UniformFrame(GLYPH_IDLE);
+    frames.clear();
+    frames.push_back(idle);
+    for (int hour = 0; hour < 24; hour++) {
+        frames.push_back(ClockFrame(hour, 0));
+        frames.push_back(idle);
+    }
+    RunSuite(config, json, "idle_time", frames);
+    json += ",";
+
+    // 5 minute countdown, one transition per second
+    frames.clear();
+    for (int seconds = 5 * 60; seconds >= 0; seconds--) {
+        frames.push_back(ClockFrame(seconds / 60, seconds % 60));
+    }
+    RunSuite(config, json, "countdown", frames);
+
+    json += "]}";
+}
+
+namespace {
+
+using KernelFunction = void (*)(const int16_t*, const int16_t*, int, int16_t, int16_t, int16_t*, int);
+
+// Average cost of one call
+struct KernelTiming {
+    double ns = 0;
+    double cycles = 0; // 0 where there is no cycle counter
+};
+
+// Time calls of body(i) for i < count
+template <typename Body>
+KernelTiming TimeCalls(int count, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t start_cycles = MotionCycleCount();
+    for (int i = 0; i < count; i++) {
+        body(i);
+    }
+    uint32_t cycles = MotionCycleCount() - start_cycles;
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    KernelTiming timing;
+    timing.ns = std::chrono::duration<double, std::nano>(elapsed).count() / count;
+    timing.cycles = (double)cycles / count;
+    return timing;
+}
+
+// One interpolation per frame, the fraction sweeping from 0 to 1
+KernelTiming TimeKernel(KernelFunction kernel, const int16_t* from, const int16_t* to, int16_t* out, int lanes) {
+    return TimeCalls(KERNEL_BENCH_FRAMES, [&](int frame) {
+        int fraction = frame * (MOTION_Q15_ONE / KERNEL_BENCH_FRAMES);
+        kernel(from, to, fraction, SERVO_POSITION_MIN, SERVO_POSITION_MAX, out, lanes);
+    });
+}
+
+void AppendTiming(std::string& json, const char* name, const KernelTiming& timing) {
+    AppendF(json, "\"%s_ns\":%.1f,\"%s_cycles\":%.1f", name, timing.ns, name, timing.cycles);
+}
+
+} // namespace
+
+void RunKernelBenchmark(std::string& json) {
+    alignas(MOTION_LANE_ALIGN) static int16_t from[KERNEL_BENCH_LANES];
+    alignas(MOTION_LANE_ALIGN) static int16_t to[KERNEL_BENCH_LANES];
+    alignas(MOTION_LANE_ALIGN) static int16_t scalar_out[KERNEL_BENCH_LANES];
+    alignas(MOTION_LANE_ALIGN) static int16_t vector_out[KERNEL_BENCH_LANES];
+
+    // Poses across the whole servo range, a few beyond it so the clamp is exercised
+    uint32_t seed = 12345;
+    for (int i = 0; i < KERNEL_BENCH_LANES; i++) {
+        seed = seed * 1103515245 + 12345;
+        from[i] = SERVO_POSITION_MIN - 20 + (seed >> 16) % (SERVO_POSITION_MAX - SERVO_POSITION_MIN + 40);
+        seed = seed * 1103515245 + 12345;
+        to[i] = SERVO_POSITION_MIN - 20 + (seed >> 16) % (SERVO_POSITION_MAX - SERVO_POSITION_MIN + 40);
+    }
+
+    AppendF(json, "{\"bench\":\"kernel\",\"kernel\":\"%s\",\"frames\":%d,\"results\":[",
+            MotionKernelName(), KERNEL_BENCH_FRAMES);
+    static const int lane_counts[] = {SERVO_LANE_NUM, KERNEL_BENCH_LANES / 2, KERNEL_BENCH_LANES};
+    for (size_t i = 0; i < sizeof(lane_counts) / sizeof(lane_counts[0]); i++) {
+        const int lanes = lane_counts[i];
+        KernelTiming scalar = TimeKernel(InterpolatePositionsScalar, from, to, scalar_out, lanes);
+        KernelTiming vector = TimeKernel(InterpolatePositions, from, to, vector_out, lanes);
+
+        int mismatches = 0;
+        for (int fraction = 0; fraction <= MOTION_Q15_ONE; fraction += 64) {
+            InterpolatePositionsScalar(from, to, fraction, SERVO_POSITION_MIN, SERVO_POSITION_MAX, scalar_out, lanes);
+            InterpolatePositions(from, to, fraction, SERVO_POSITION_MIN, SERVO_POSITION_MAX, vector_out, lanes);
+            for (int lane = 0; lane < lanes; lane++) {
+                if (scalar_out[lane] != vector_out[lane]) mismatches++;
+            }
+        }
+
+        if (i) json += ",";
+        AppendF(json, "{\"channels\":%d,", lanes);
+        AppendTiming(json, "scalar", scalar);
+        json += ",";
+        AppendTiming(json, "vector", vector);
+        // Share of one core spent on frames at 1 kHz
+        AppendF(json, ",\"speedup\":%.2f,\"cpu_pct_1khz\":%.3f,\"mismatches\":%d}",
+                vector.ns > 0 ? scalar.ns / vector.ns : 0.0, vector.ns / 1e4, mismatches);
+    }
+    json += "],";
+
+    // Easing table lookup, every curve across the whole interval
+    volatile int sink = 0;
+    KernelTiming ease = TimeCalls(KERNEL_BENCH_FRAMES, [&](int i) {
+        sink = sink + AnimEaseQ15(i % ANIM_EASE_STEP, (i * 7919) & (MOTION_Q15_ONE - 1));
+    });
+    json += "\"ease\":{";
+    AppendTiming(json, "table", ease);
+    json += "},";
+
+    // Whole animation frames: keyframe bookkeeping, easing and the kernel
+    const Animation& animation = kAnimations[0];
+    const ServoProfile& profile = kServoProfiles[0];
+    const int offsets[SERVO_CHANNEL_NUM] = {0};
+    int start[SERVO_CHANNEL_NUM];
+    int glyphs[CLOCK_DIGIT_NUM];
+    std::fill(glyphs, glyphs + CLOCK_DIGIT_NUM, GLYPH_OFF);
+    GetGlyphTargets(profile, offsets, glyphs, start);
+    AnimationPlayer player;
+    player.Start(animation, profile, offsets, start);
+    const int frame_num = player.FrameNum();
+    int positions[SERVO_CHANNEL_NUM];
+    KernelTiming sample = TimeCalls(frame_num, [&](int frame) { player.Sample(frame, positions); });
+    AppendF(json, "\"animation\":{\"name\":\"%s\",\"frames\":%d,", animation.name, frame_num);
+    AppendTiming(json, "frame", sample);
+    json += "},";
+
+    // Motion trace cost per commanded position, while stopped and while recording
+    MotionTrace trace;
+    KernelTiming trace_off = TimeCalls(KERNEL_BENCH_FRAMES, [&](int i) {
+        trace.RecordPosition(i, i % SERVO_CHANNEL_NUM, i & 0x3FF, TRACE_STEP);
+    });
+    json += "\"trace\":{";
+    AppendTiming(json, "off", trace_off);
+    if (trace.Enable(true)) {
+        KernelTiming trace_on = TimeCalls(KERNEL_BENCH_FRAMES, [&](int i) {
+            trace.RecordPosition(i, i % SERVO_CHANNEL_NUM, i & 0x3FF, TRACE_STEP);
+        });
+        json += ",";
+        AppendTiming(json, "on", trace_on);
+        AppendF(json, ",\"records\":%u,\"bytes\":%u", (unsigned)trace.Count(),
+                (unsigned)(TRACE_RECORD_NUM * sizeof(TraceRecord)));
+    }
+    json += "}}";
+}
+
+namespace {
+
+struct CorpusResult {
+    std::string plan;
+    int32_t time_us;
+    int missed; // Segment the executed plan left away from its target, -1 for none
+};
+
+// Plan and time from -> to on the first digit while the others keep showing CORPUS_REST_GLYPH.
+// The plan is encoded per move as "segment:from>to", "a" marks an avoidance move and
+// "@n" the segment it waits for.
+CorpusResult PlanCorpusTransition(int profile_index, int from, int to) {
+    const ServoProfile& profile = kServoProfiles[profile_index];
+    const int offsets[SERVO_CHANNEL_NUM] = {0};
+    int current[SERVO_CHANNEL_NUM];
+    int target[SERVO_CHANNEL_NUM];
+    int glyphs[CLOCK_DIGIT_NUM];
+    std::fill(glyphs, glyphs + CLOCK_DIGIT_NUM, CORPUS_REST_GLYPH);
+    glyphs[0] = from;
+    GetGlyphTargets(profile, offsets, glyphs, current);
+
+    std::vector<ServoState> plan;
+    glyphs[0] = to;
+    PlanDisplayTransition(profile, offsets, current, glyphs, SERVO_STEP_FAST, target, plan);
+    OptimizeMoveOrder(plan, MOTION_POOL_BENCH);
+
+    CorpusResult result;
+    for (const auto& task : plan) {
+        if (!result.plan.empty()) result.plan += ",";
+        AppendF(result.plan, "%d:%d>%d", task.channel, task.current_position, task.target_position);
+        if (task.avoidance) result.plan += "a";
+        for (int front_channel : task.front_channels) {
+            if (front_channel != -1) AppendF(result.plan, "@%d", front_channel);
+        }
+    }
+    result.time_us = (int32_t)SimulatePlan(plan, current, MotionBenchConfig().i2c_transaction_us).time_us;
+    result.missed = -1;
+    for (int channel = 0; channel < SERVO_CHANNEL_NUM; channel++) {
+        if (current[channel] != target[channel]) {
+            result.missed = channel;
+            break;
+        }
+    }
+    return result;
+}
+
+void AppendCorpusKey(std::string& json, const MotionCorpusEntry& entry) {
+    AppendF(json, "{\"profile\":\"%s\",\"from\":%d,\"to\":%d,",
+            kServoProfiles[entry.profile].name, entry.from, entry.to);
+}
+
+} // namespace
+
+int CheckMotionCorpus(std::string& json) {
+    std::vector<const MotionCorpusEntry*> changed, slower, faster, missed;
+    std::vector<CorpusResult> results;
+    int64_t expected_total_us = 0, actual_total_us = 0;
+    const size_t entries = sizeof(kMotionCorpus) / sizeof(kMotionCorpus[0]);
+    results.reserve(entries);
+
+    for (size_t i = 0; i < entries; i++) {
+        const MotionCorpusEntry& entry = kMotionCorpus[i];
+        results.push_back(PlanCorpusTransition(entry.profile, entry.from, entry.to));
+        const CorpusResult& actual = results.back();
+        expected_total_us += entry.time_us;
+        actual_total_us += actual.time_us;
+        if (actual.plan != entry.plan) changed.push_back(&entry);
+        if (actual.time_us > entry.time_us) slower.push_back(&entry);
+        if (actual.time_us < entry.time_us) faster.push_back(&entry);
+        if (actual.missed != -1) missed.push_back(&entry);
+    }
+
+    auto AppendTimes = [&](const char* name, const std::vector<const MotionCorpusEntry*>& list) {
+        AppendF(json, "\"%s\":%u,\"%s_list\":[", name, (unsigned)list.size(), name);
+        for (size_t i = 0; i < list.size() && i < CORPUS_DIFF_NUM; i++) {
+            const CorpusResult& actual = results[list[i] - kMotionCorpus];
+            if (i) json += ",";
+            AppendCorpusKey(json, *list[i]);
+            AppendF(json, "\"expected_ms\":%.1f,\"actual_ms\":%.1f}", list[i]->time_us / 1000.0, actual.time_us / 1000.0);
+        }
+        json += "],";
+    };
+
+    AppendF(json, "{\"corpus\":\"motion\",\"entries\":%u,", (unsigned)entries);
+    AppendF(json, "\"expected_total_ms\":%.1f,\"actual_total_ms\":%.1f,",
+            expected_total_us / 1000.0, actual_total_us / 1000.0);
+    AppendTimes("slower", slower);
+    AppendTimes("faster", faster);
+    AppendF(json, "\"changed\":%u,\"changed_list\":[", (unsigned)changed.size());
+    for (size_t i = 0; i < changed.size() && i < CORPUS_DIFF_NUM; i++) {
+        if (i) json += ",";
+        AppendCorpusKey(json, *changed[i]);
+        json += "\"expected\":\"";
+        json += changed[i]->plan;
+        json += "\",\"actual\":\"";
+        json += results[changed[i] - kMotionCorpus].plan;
+        json += "\"}";
+    }
+    AppendF(json, "],\"missed\":%u,\"missed_list\":[", (unsigned)missed.size());
+    for (size_t i = 0; i < missed.size() && i < CORPUS_DIFF_NUM; i++) {
+        const CorpusResult& actual = results[missed[i] - kMotionCorpus];
+        if (i) json += ",";
+        AppendCorpusKey(json, *missed[i]);
+        AppendF(json, "\"segment\":%d,\"plan\":\"%s\"}", actual.missed, actual.plan.c_str());
+    }
+
+    // Every plan above ran its moves as scripts, so the largest frame of this build is known
+    const size_t frame_bytes = MotionPoolLargestRequest();
+    const bool frame_fits = frame_bytes <= MOTION_SCRIPT_FRAME_SIZE;
+    AppendF(json, "],\"frame_bytes\":%u,\"frame_size\":%u,\"frame_fits\":%s}",
+            (unsigned)frame_bytes, (unsigned)MOTION_SCRIPT_FRAME_SIZE, frame_fits ? "true" : "false");
+    return (int)(changed.size() + missed.size()) + (frame_fits ? 0 : 1);
+}
+
+void GenerateMotionCorpus(std::string& out) {
+    out += "#ifndef MOTION_CORPUS_H\n#define MOTION_CORPUS_H\n\n";
+    out += "// Golden motion-plan corpus, generated by GET /bench?corpus=generate.\n";
+    out += "// Regenerate it only when a planner change is intended, and review the\n";
+    out += "// GET /bench?corpus=check report of the old corpus before replacing it.\n";
+    out += "// {profile, from glyph, to glyph, plan, modelled makespan in us}\n\n";
+    out += "static const MotionCorpusEntry kMotionCorpus[] = {\n";
+    for (int profile = 0; profile < 2; profile++) {
+        for (int from = 0; from < GLYPH_NUM; from++) {
+            for (int to = 0; to < GLYPH_NUM; to++) {
+                CorpusResult result = PlanCorpusTransition(profile, from, to);
+                AppendF(out, "    {%d, %d, %d, \"", profile, from, to);
+                out += result.plan;
+                AppendF(out, "\", %ld},\n", (long)result.time_us);
+            }
+        }
+    }
+    out += "};\n\n#endif // MOTION_CORPUS_H\n";
+}
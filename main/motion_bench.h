@@ -0,0 +1,62 @@
+#ifndef MOTION_BENCH_H
+#define MOTION_BENCH_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "motion_engine.h"
+#include "speed_profile.h"
+
+// Transition benchmark: replays whole days of display changes through the motion
+// planner and engine without touching the servos, and reports the results as JSON.
+// Free of ESP-IDF headers, so the same code runs on the device and on a host build.
+
+struct MotionBenchConfig {
+    int servo_profile = 0;          // SERVO_PROFILE_A / SERVO_PROFILE_B
+    int speed = SPEED_FAST;         // SpeedProfileId the moves are planned with
+    bool optimize_order = true;     // Apply OptimizeMoveOrder like the firmware does
+    int i2c_transaction_us = 100;   // Modelled duration of one write transaction on the bus
+};
+
+// Modelled cost of executing one plan
+struct MotionSimResult {
+    int64_t time_us = 0;
+    int moves = 0;
+    int avoid_moves = 0;
+    int i2c_transactions = 0;
+    int rounds = 0;
+    int dropped = 0; // Moves of plans aborted because a script frame was missing, never run
+};
+
+// Execute plan through MotionEngine the same way ExecuteTask does, without servos, on an
+// engine drawing from MOTION_POOL_BENCH. current[] is updated to the final positions, and
+// stays as it was when the plan was aborted.
+MotionSimResult SimulatePlan(const std::vector<ServoState>& plan, int* current, int i2c_transaction_us);
+
+// Run every suite and append the JSON report to json
+void RunMotionBenchmark(const MotionBenchConfig& config, std::string& json);
+
+// Time the per-frame interpolation kernel, scalar and vector version, for several channel
+// counts and append the JSON report. Also counts lanes where the two versions disagree.
+void RunKernelBenchmark(std::string& json);
+
+// Golden motion-plan corpus: the expected plan and makespan of every glyph
+// transition on one digit, for both servo profiles (see motion_corpus.h).
+struct MotionCorpusEntry {
+    uint8_t profile;
+    uint8_t from;
+    uint8_t to;
+    const char* plan;
+    int32_t time_us;
+};
+
+// Compare the current planner against the corpus and append a JSON diff report.
+// Returns the number of transitions whose plan changed or that leave a segment
+// away from its target once executed, plus one when a script frame of this build
+// is larger than MOTION_SCRIPT_FRAME_SIZE.
+int CheckMotionCorpus(std::string& json);
+
+// Emit a new motion_corpus.h from the current planner
+void GenerateMotionCorpus(std::string& out);
+
+#endif // MOTION_BENCH_H
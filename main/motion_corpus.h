@@ -0,0 +1,300 @@
+#ifndef MOTION_CORPUS_H
+#define MOTION_CORPUS_H
+
+// Golden motion-plan corpus, generated by GET /bench?corpus=generate.
+// Regenerate it only when a planner change is intended, and review the
+// GET /bench?corpus=check report of the old corpus before replacing it.
+// {profile, from glyph, to glyph, plan, modelled makespan in us}
+
+static const MotionCorpusEntry kMotionCorpus[] = {
+    {0, 0, 0, "", 15000},
+    {0, 0, 1, "0:110>300,3:330>140,4:330>140,5:310>120", 316600},
+    {0, 0, 2, "1:110>230a,5:310>190,6:300>110@1@5,1:230>110@6@1,2:120>310,5:190>120@5", 346900},
+    {0, 0, 3, "1:110>230a,5:310>190,6:300>110@1@5,1:230>110@6@1,4:330>140,5:190>120@5", 346900},
+    {0, 0, 4, "1:110>230a,5:310>190a,6:300>110@1@5,0:110>300,1:230>110@6@1,3:330>140,4:330>140,5:190>310@6@5", 482800},
+    {0, 0, 5, "1:110>230,5:310>190a,6:300>110@1@5,1:230>300@1,4:330>140,5:190>310@6@5", 346900},
+    {0, 0, 6, "1:110>230,5:310>190a,6:300>110@1@5,1:230>300@1,5:190>310@6@5", 286500},
+    {0, 0, 7, "3:330>140,4:330>140,5:310>120", 256200},
+    {0, 0, 8, "1:110>230a,5:310>190a,6:300>110@1@5,1:230>110@6@1,5:190>310@6@5", 301600},
+    {0, 0, 9, "1:110>230a,5:310>190a,6:300>110@1@5,1:230>110@6@1,4:330>140,5:190>310@6@5", 362000},
+    {0, 0, 10, "0:110>300,1:110>300,2:120>310,3:330>140,4:330>140,5:310>120", 437400},
+    {0, 0, 11, "1:110>230,5:310>190,6:300>110@1@5,0:110>300,2:120>310,3:330>140,4:330>140,1:230>300@1,5:190>120@5", 498000},
+    {0, 1, 0, "0:300>110,3:140>330,4:140>330,5:120>310", 316600},
+    {0, 1, 1, "", 15000},
+    {0, 1, 2, "1:110>230a,6:300>110@1,0:300>110,1:230>110@6@1,2:120>310,3:140>330,4:140>330", 452600},
+    {0, 1, 3, "1:110>230a,6:300>110@1,0:300>110,1:230>110@6@1,3:140>330", 331800},
+    {0, 1, 4, "1:110>230a,5:120>190,6:300>110@1,1:230>110@6@1,5:190>310@6@5", 286500},
+    {0, 1, 5, "1:110>230,5:120>190,6:300>110@1,0:300>110,1:230>300@1,3:140>330,5:190>310@6@5", 392200},
+    {0, 1, 6, "1:110>230,5:120>190,6:300>110@1,0:300>110,1:230>300@1,3:140>330,4:140>330,5:190>310@6@5", 452600},
+    {0, 1, 7, "0:300>110", 135400},
+    {0, 1, 8, "1:110>230a,5:120>190,6:300>110@1,0:300>110,1:230>110@6@1,3:140>330,4:140>330,5:190>310@6@5", 467700},
+    {0, 1, 9, "1:110>230a,5:120>190,6:300>110@1,0:300>110,1:230>110@6@1,3:140>330,5:190>310@6@5", 407300},
+    {0, 1, 10, "1:110>300,2:120>310", 195800},
+    {0, 1, 11, "1:110>230,6:300>110@1,1:230>300@1,2:120>310", 271300},
+    {0, 2, 0, "1:110>230a,5:120>190,6:110>300@1,1:230>110@6@1,2:310>120,5:190>310@6@5", 346900},
+    {0, 2, 1, "1:110>230a,6:110>300@1,0:110>300,1:230>110@6@1,2:310>120,3:330>140,4:330>140", 452600},
+    {0, 2, 2, "", 15000},
+    {0, 2, 3, "2:310>120,4:330>140", 195800},
+    {0, 2, 4, "0:110>300,2:310>120,3:330>140,4:330>140,5:120>310", 317000},
+    {0, 2, 5, "1:110>300,2:310>120,4:330>140,5:120>310", 316600},
+    {0, 2, 6, "1:110>300,2:310>120,5:120>310", 256200},
+    {0, 2, 7, "1:110>230a,6:110>300@1,1:230>110@6@1,2:310>120,3:330>140,4:330>140", 392200},
+    {0, 2, 8, "2:310>120,5:120>310", 195800},
+    {0, 2, 9, "2:310>120,4:330>140,5:120>310", 256200},
+    {0, 2, 10, "1:110>230,6:110>300@1,0:110>300,1:230>300@1,3:330>140,4:330>140", 362100},
+    {0, 2, 11, "0:110>300,1:110>300,3:330>140,4:330>140", 316600},
+    {0, 3, 0, "1:110>230a,5:120>190,6:110>300@1,1:230>110@6@1,4:140>330,5:190>310@6@5", 346900},
+    {0, 3, 1, "1:110>230a,6:110>300@1,0:110>300,1:230>110@6@1,3:330>140", 331800},
+    {0, 3, 2, "2:120>310,4:140>330", 195800},
+    {0, 3, 3, "", 15000},
+    {0, 3, 4, "0:110>300,3:330>140,5:120>310", 256200},
+    {0, 3, 5, "1:110>300,5:120>310", 195800},
+    {0, 3, 6, "1:110>300,4:140>330,5:120>310", 256200},
+    {0, 3, 7, "1:110>230a,6:110>300@1,1:230>110@6@1,3:330>140", 271400},
+    {0, 3, 8, "4:140>330,5:120>310", 195800},
+    {0, 3, 9, "5:120>310", 135400},
+    {0, 3, 10, "1:110>230,6:110>300@1,0:110>300,1:230>300@1,2:120>310,3:330>140", 362100},
+    {0, 3, 11, "0:110>300,1:110>300,2:120>310,3:330>140", 316600},
+    {0, 4, 0, "1:110>230a,5:310>190a,6:110>300@1@5,0:300>110,1:230>110@6@1,3:140>330,4:140>330,5:190>310@6@5", 482800},
+    {0, 4, 1, "1:110>230a,5:310>190,6:110>300@1@5,1:230>110@6@1,5:190>120@5", 286500},
+    {0, 4, 2, "0:300>110,2:120>310,3:140>330,4:140>330,5:310>120", 317000},
+    {0, 4, 3, "0:300>110,3:140>330,5:310>120", 256200},
+    {0, 4, 4, "", 15000},
+    {0, 4, 5, "0:300>110,1:110>300,3:140>330", 256200},
+    {0, 4, 6, "0:300>110,1:110>300,3:140>330,4:140>330", 316600},
+    {0, 4, 7, "1:110>230a,5:310>190,6:110>300@1@5,0:300>110,1:230>110@6@1,5:190>120@5", 346900},
+    {0, 4, 8, "0:300>110,3:140>330,4:140>330", 256200},
+    {0, 4, 9, "0:300>110,3:140>330", 195800},
+    {0, 4, 10, "1:110>230,5:310>190,6:110>300@1@5,1:230>300@1,2:120>310,5:190>120@5", 331800},
+    {0, 4, 11, "1:110>300,2:120>310,5:310>120", 256200},
+    {0, 5, 0, "1:300>230,5:310>190a,6:110>300@5,1:230>110@6@1,4:140>330,5:190>310@6@5", 346900},
+    {0, 5, 1, "1:300>230,5:310>190,6:110>300@5,0:110>300,1:230>110@6@1,3:330>140,5:190>120@5", 392200},
+    {0, 5, 2, "1:300>110,2:120>310,4:140>330,5:310>120", 316600},
+    {0, 5, 3, "1:300>110,5:310>120", 195800},
+    {0, 5, 4, "0:110>300,1:300>110,3:330>140", 256200},
+    {0, 5, 5, "", 15000},
+    {0, 5, 6, "4:140>330", 135400},
+    {0, 5, 7, "1:300>230,5:310>190,6:110>300@5,1:230>110@6@1,3:330>140,5:190>120@5", 331800},
+    {0, 5, 8, "1:300>110,4:140>330", 195800},
+    {0, 5, 9, "1:300>110", 135400},
+    {0, 5, 10, "5:310>190,6:110>300@5,0:110>300,2:120>310,3:330>140,5:190>120@5", 362100},
+    {0, 5, 11, "0:110>300,2:120>310,3:330>140,5:310>120", 316600},
+    {0, 6, 0, "1:300>230,5:310>190a,6:110>300@5,1:230>110@6@1,5:190>310@6@5", 286500},
+    {0, 6, 1, "1:300>230,5:310>190,6:110>300@5,0:110>300,1:230>110@6@1,3:330>140,4:330>140,5:190>120@5", 452600},
+    {0, 6, 2, "1:300>110,2:120>310,5:310>120", 256200},
+    {0, 6, 3, "1:300>110,4:330>140,5:310>120", 256200},
+    {0, 6, 4, "0:110>300,1:300>110,3:330>140,4:330>140", 316600},
+    {0, 6, 5, "4:330>140", 135400},
+    {0, 6, 6, "", 15000},
+    {0, 6, 7, "1:300>230,5:310>190,6:110>300@5,1:230>110@6@1,3:330>140,4:330>140,5:190>120@5", 392200},
+    {0, 6, 8, "1:300>110", 135400},
+    {0, 6, 9, "1:300>110,4:330>140", 195800},
+    {0, 6, 10, "5:310>190,6:110>300@5,0:110>300,2:120>310,3:330>140,4:330>140,5:190>120@5", 422500},
+    {0, 6, 11, "0:110>300,2:120>310,3:330>140,4:330>140,5:310>120", 317000},
+    {0, 7, 0, "3:140>330,4:140>330,5:120>310", 256200},
+    {0, 7, 1, "0:110>300", 135400},
+    {0, 7, 2, "1:110>230a,6:300>110@1,1:230>110@6@1,2:120>310,3:140>330,4:140>330", 392200},
+    {0, 7, 3, "1:110>230a,6:300>110@1,1:230>110@6@1,3:140>330", 271400},
+    {0, 7, 4, "1:110>230a,5:120>190,6:300>110@1,0:110>300,1:230>110@6@1,5:190>310@6@5", 346900},
+    {0, 7, 5, "1:110>230,5:120>190,6:300>110@1,1:230>300@1,3:140>330,5:190>310@6@5", 331800},
+    {0, 7, 6, "1:110>230,5:120>190,6:300>110@1,1:230>300@1,3:140>330,4:140>330,5:190>310@6@5", 392200},
+    {0, 7, 7, "", 15000},
+    {0, 7, 8, "1:110>230a,5:120>190,6:300>110@1,1:230>110@6@1,3:140>330,4:140>330,5:190>310@6@5", 407300},
+    {0, 7, 9, "1:110>230a,5:120>190,6:300>110@1,1:230>110@6@1,3:140>330,5:190>310@6@5", 346900},
+    {0, 7, 10, "0:110>300,1:110>300,2:120>310", 256200},
+    {0, 7, 11, "1:110>230,6:300>110@1,0:110>300,1:230>300@1,2:120>310", 316700},
+    {0, 8, 0, "1:110>230a,5:310>190a,6:110>300@1@5,1:230>110@6@1,5:190>310@6@5", 301600},
+    {0, 8, 1, "1:110>230a,5:310>190,6:110>300@1@5,0:110>300,1:230>110@6@1,3:330>140,4:330>140,5:190>120@5", 467700},
+    {0, 8, 2, "2:120>310,5:310>120", 195800},
+    {0, 8, 3, "4:330>140,5:310>120", 195800},
+    {0, 8, 4, "0:110>300,3:330>140,4:330>140", 256200},
+    {0, 8, 5, "1:110>300,4:330>140", 195800},
+    {0, 8, 6, "1:110>300", 135400},
+    {0, 8, 7, "1:110>230a,5:310>190,6:110>300@1@5,1:230>110@6@1,3:330>140,4:330>140,5:190>120@5", 407300},
+    {0, 8, 8, "", 15000},
+    {0, 8, 9, "4:330>140", 135400},
+    {0, 8, 10, "1:110>230,5:310>190,6:110>300@1@5,0:110>300,2:120>310,3:330>140,4:330>140,1:230>300@1,5:190>120@5", 498000},
+    {0, 8, 11, "0:110>300,1:110>300,2:120>310,3:330>140,4:330>140,5:310>120", 437400},
+    {0, 9, 0, "1:110>230a,5:310>190a,6:110>300@1@5,1:230>110@6@1,4:140>330,5:190>310@6@5", 362000},
+    {0, 9, 1, "1:110>230a,5:310>190,6:110>300@1@5,0:110>300,1:230>110@6@1,3:330>140,5:190>120@5", 407300},
+    {0, 9, 2, "2:120>310,4:140>330,5:310>120", 256200},
+    {0, 9, 3, "5:310>120", 135400},
+    {0, 9, 4, "0:110>300,3:330>140", 195800},
+    {0, 9, 5, "1:110>300", 135400},
+    {0, 9, 6, "1:110>300,4:140>330", 195800},
+    {0, 9, 7, "1:110>230a,5:310>190,6:110>300@1@5,1:230>110@6@1,3:330>140,5:190>120@5", 346900},
+    {0, 9, 8, "4:140>330", 135400},
+    {0, 9, 9, "", 15000},
+    {0, 9, 10, "1:110>230,5:310>190,6:110>300@1@5,0:110>300,1:230>300@1,2:120>310,3:330>140,5:190>120@5", 437600},
+    {0, 9, 11, "0:110>300,1:110>300,2:120>310,3:330>140,5:310>120", 317000},
+    {0, 10, 0, "0:300>110,1:300>110,2:310>120,3:140>330,4:140>330,5:120>310", 437400},
+    {0, 10, 1, "1:300>110,2:310>120", 195800},
+    {0, 10, 2, "1:300>230,6:300>110,0:300>110,1:230>110@6@1,3:140>330,4:140>330", 362100},
+    {0, 10, 3, "1:300>230,6:300>110,0:300>110,1:230>110@6@1,2:310>120,3:140>330", 362100},
+    {0, 10, 4, "1:300>230,5:120>190,6:300>110,1:230>110@6@1,2:310>120,5:190>310@6@5", 331800},
+    {0, 10, 5, "5:120>190,6:300>110,0:300>110,2:310>120,3:140>330,5:190>310@6@5", 362100},
+    {0, 10, 6, "5:120>190,6:300>110,0:300>110,2:310>120,3:140>330,4:140>330,5:190>310@6@5", 437500},
+    {0, 10, 7, "0:300>110,1:300>110,2:310>120", 256200},
+    {0, 10, 8, "1:300>230,5:120>190,6:300>110,0:300>110,1:230>110@6@1,2:310>120,3:140>330,4:140>330,5:190>310@6@5", 513000},
+    {0, 10, 9, "1:300>230,5:120>190,6:300>110,0:300>110,1:230>110@6@1,2:310>120,3:140>330,5:190>310@6@5", 452600},
+    {0, 10, 10, "", 15000},
+    {0, 10, 11, "6:300>110", 135400},
+    {0, 11, 0, "1:300>230,5:120>190,6:110>300,0:300>110,1:230>110@6@1,2:310>120,3:140>330,4:140>330,5:190>310@6@5", 513000},
+    {0, 11, 1, "1:300>230,6:110>300,1:230>110@6@1,2:310>120", 256300},
+    {0, 11, 2, "0:300>110,1:300>110,3:140>330,4:140>330", 316600},
+    {0, 11, 3, "0:300>110,1:300>110,2:310>120,3:140>330", 316600},
+    {0, 11, 4, "1:300>110,2:310>120,5:120>310", 256200},
+    {0, 11, 5, "0:300>110,2:310>120,3:140>330,5:120>310", 316600},
+    {0, 11, 6, "0:300>110,2:310>120,3:140>330,4:140>330,5:120>310", 317000},
+    {0, 11, 7, "1:300>230,6:110>300,0:300>110,1:230>110@6@1,2:310>120", 316700},
+    {0, 11, 8, "0:300>110,1:300>110,2:310>120,3:140>330,4:140>330,5:120>310", 437400},
+    {0, 11, 9, "0:300>110,1:300>110,2:310>120,3:140>330,5:120>310", 317000},
+    {0, 11, 10, "6:110>300", 135400},
+    {0, 11, 11, "", 15000},
+    {1, 0, 0, "", 15000},
+    {1, 0, 1, "0:325>525,3:325>125,4:325>125,5:325>125", 316600},
+    {1, 0, 2, "1:325>375a,5:325>275,6:525>325@1@5,1:375>325@6@1,2:325>525,5:275>125@5", 241400},
+    {1, 0, 3, "1:325>375a,5:325>275,6:525>325@1@5,1:375>325@6@1,4:325>125,5:275>125@5", 241400},
+    {1, 0, 4, "1:325>375a,5:325>275a,6:525>325@1@5,0:325>525,1:375>325@6@1,3:325>125,4:325>125,5:275>325@6@5", 332000},
+    {1, 0, 5, "1:325>375,5:325>275a,6:525>325@1@5,1:375>525@1,4:325>125,5:275>325@6@5", 241400},
+    {1, 0, 6, "1:325>375,5:325>275a,6:525>325@1@5,1:375>525@1,5:275>325@6@5", 181000},
+    {1, 0, 7, "3:325>125,4:325>125,5:325>125", 256200},
+    {1, 0, 8, "1:325>375a,5:325>275a,6:525>325@1@5,1:375>325@6@1,5:275>325@6@5", 150800},
+    {1, 0, 9, "1:325>375a,5:325>275a,6:525>325@1@5,1:375>325@6@1,4:325>125,5:275>325@6@5", 211200},
+    {1, 0, 10, "0:325>525,1:325>525,2:325>525,3:325>125,4:325>125,5:325>125", 437400},
+    {1, 0, 11, "1:325>375,5:325>275,6:525>325@1@5,0:325>525,1:375>525@1,2:325>525,3:325>125,4:325>125,5:275>125@5", 482800},
+    {1, 1, 0, "0:525>325,3:125>325,4:125>325,5:125>325", 316600},
+    {1, 1, 1, "", 15000},
+    {1, 1, 2, "1:325>375a,6:525>325@1,0:525>325,2:325>525,3:125>325,4:125>325,1:375>325@6@1", 362200},
+    {1, 1, 3, "1:325>375a,6:525>325@1,0:525>325,1:375>325@6@1,3:125>325", 241400},
+    {1, 1, 4, "1:325>375a,5:125>275,6:525>325@1,1:375>325@6@1,5:275>325@6@5", 181000},
+    {1, 1, 5, "1:325>375,6:525>325@1,0:525>325,3:125>325,5:125>275,1:375>525@1,5:275>325@6@5", 317000},
+    {1, 1, 6, "1:325>375,6:525>325@1,5:125>275,0:525>325,3:125>325,4:125>325,1:375>525@1,5:275>325@6@5", 407400},
+    {1, 1, 7, "0:525>325", 135400},
+    {1, 1, 8, "1:325>375a,5:125>275,6:525>325@1,0:525>325,1:375>325@6@1,3:125>325,4:125>325,5:275>325@6@5", 362200},
+    {1, 1, 9, "1:325>375a,5:125>275,6:525>325@1,0:525>325,1:375>325@6@1,3:125>325,5:275>325@6@5", 286800},
+    {1, 1, 10, "1:325>525,2:325>525", 195800},
+    {1, 1, 11, "1:325>375,6:525>325@1,1:375>525@1,2:325>525", 256200},
+    {1, 2, 0, "1:325>375a,5:125>275,6:325>525@1,1:375>325@6@1,2:525>325,5:275>325@6@5", 241400},
+    {1, 2, 1, "1:325>375a,6:325>525@1,0:325>525,2:525>325,3:325>125,4:325>125,1:375>325@6@1", 362200},
+    {1, 2, 2, "", 15000},
+    {1, 2, 3, "2:525>325,4:325>125", 195800},
+    {1, 2, 4, "0:325>525,2:525>325,3:325>125,4:325>125,5:125>325", 317000},
+    {1, 2, 5, "1:325>525,2:525>325,4:325>125,5:125>325", 316600},
+    {1, 2, 6, "1:325>525,2:525>325,5:125>325", 256200},
+    {1, 2, 7, "1:325>375a,6:325>525@1,1:375>325@6@1,2:525>325,3:325>125,4:325>125", 286800},
+    {1, 2, 8, "2:525>325,5:125>325", 195800},
+    {1, 2, 9, "2:525>325,4:325>125,5:125>325", 256200},
+    {1, 2, 10, "1:325>375,6:325>525@1,0:325>525,3:325>125,4:325>125,1:375>525@1", 317000},
+    {1, 2, 11, "0:325>525,1:325>525,3:325>125,4:325>125", 316600},
+    {1, 3, 0, "1:325>375a,5:125>275,6:325>525@1,1:375>325@6@1,4:125>325,5:275>325@6@5", 241400},
+    {1, 3, 1, "1:325>375a,6:325>525@1,0:325>525,1:375>325@6@1,3:325>125", 241400},
+    {1, 3, 2, "2:325>525,4:125>325", 195800},
+    {1, 3, 3, "", 15000},
+    {1, 3, 4, "0:325>525,3:325>125,5:125>325", 256200},
+    {1, 3, 5, "1:325>525,5:125>325", 195800},
+    {1, 3, 6, "1:325>525,4:125>325,5:125>325", 256200},
+    {1, 3, 7, "1:325>375a,6:325>525@1,1:375>325@6@1,3:325>125", 181000},
+    {1, 3, 8, "4:125>325,5:125>325", 195800},
+    {1, 3, 9, "5:125>325", 135400},
+    {1, 3, 10, "1:325>375,6:325>525@1,0:325>525,2:325>525,3:325>125,1:375>525@1", 317000},
+    {1, 3, 11, "0:325>525,1:325>525,2:325>525,3:325>125", 316600},
+    {1, 4, 0, "1:325>375a,5:325>275a,6:325>525@1@5,0:525>325,1:375>325@6@1,3:125>325,4:125>325,5:275>325@6@5", 332000},
+    {1, 4, 1, "1:325>375a,5:325>275,6:325>525@1@5,1:375>325@6@1,5:275>125@5", 181000},
+    {1, 4, 2, "0:525>325,2:325>525,3:125>325,4:125>325,5:325>125", 317000},
+    {1, 4, 3, "0:525>325,3:125>325,5:325>125", 256200},
+    {1, 4, 4, "", 15000},
+    {1, 4, 5, "0:525>325,1:325>525,3:125>325", 256200},
+    {1, 4, 6, "0:525>325,1:325>525,3:125>325,4:125>325", 316600},
+    {1, 4, 7, "1:325>375a,5:325>275,6:325>525@1@5,0:525>325,1:375>325@6@1,5:275>125@5", 241400},
+    {1, 4, 8, "0:525>325,3:125>325,4:125>325", 256200},
+    {1, 4, 9, "0:525>325,3:125>325", 195800},
+    {1, 4, 10, "1:325>375,5:325>275,6:325>525@1@5,1:375>525@1,2:325>525,5:275>125@5", 301600},
+    {1, 4, 11, "1:325>525,2:325>525,5:325>125", 256200},
+    {1, 5, 0, "1:525>375,5:325>275a,6:325>525@5,1:375>325@6@1,4:125>325,5:275>325@6@5", 241400},
+    {1, 5, 1, "1:525>375,5:325>275,6:325>525@5,0:325>525,1:375>325@6@1,3:325>125,5:275>125@5", 317000},
+    {1, 5, 2, "1:525>325,2:325>525,4:125>325,5:325>125", 316600},
+    {1, 5, 3, "1:525>325,5:325>125", 195800},
+    {1, 5, 4, "0:325>525,1:525>325,3:325>125", 256200},
+    {1, 5, 5, "", 15000},
+    {1, 5, 6, "4:125>325", 135400},
+    {1, 5, 7, "1:525>375,5:325>275,6:325>525@5,1:375>325@6@1,3:325>125,5:275>125@5", 271600},
+    {1, 5, 8, "1:525>325,4:125>325", 195800},
+    {1, 5, 9, "1:525>325", 135400},
+    {1, 5, 10, "5:325>275,6:325>525@5,0:325>525,2:325>525,3:325>125,5:275>125@5", 317000},
+    {1, 5, 11, "0:325>525,2:325>525,3:325>125,5:325>125", 316600},
+    {1, 6, 0, "1:525>375,5:325>275a,6:325>525@5,1:375>325@6@1,5:275>325@6@5", 181000},
+    {1, 6, 1, "5:325>275,6:325>525@5,1:525>375,0:325>525,3:325>125,4:325>125,5:275>125@5,1:375>325@6@1", 407400},
+    {1, 6, 2, "1:525>325,2:325>525,5:325>125", 256200},
+    {1, 6, 3, "1:525>325,4:325>125,5:325>125", 256200},
+    {1, 6, 4, "0:325>525,1:525>325,3:325>125,4:325>125", 316600},
+    {1, 6, 5, "4:325>125", 135400},
+    {1, 6, 6, "", 15000},
+    {1, 6, 7, "1:525>375,5:325>275,6:325>525@5,1:375>325@6@1,3:325>125,4:325>125,5:275>125@5", 317000},
+    {1, 6, 8, "1:525>325", 135400},
+    {1, 6, 9, "1:525>325,4:325>125", 195800},
+    {1, 6, 10, "5:325>275,6:325>525@5,0:325>525,2:325>525,3:325>125,4:325>125,5:275>125@5", 422400},
+    {1, 6, 11, "0:325>525,2:325>525,3:325>125,4:325>125,5:325>125", 317000},
+    {1, 7, 0, "3:125>325,4:125>325,5:125>325", 256200},
+    {1, 7, 1, "0:325>525", 135400},
+    {1, 7, 2, "1:325>375a,6:525>325@1,1:375>325@6@1,2:325>525,3:125>325,4:125>325", 286800},
+    {1, 7, 3, "1:325>375a,6:525>325@1,1:375>325@6@1,3:125>325", 181000},
+    {1, 7, 4, "1:325>375a,5:125>275,6:525>325@1,0:325>525,1:375>325@6@1,5:275>325@6@5", 241400},
+    {1, 7, 5, "1:325>375,5:125>275,6:525>325@1,1:375>525@1,3:125>325,5:275>325@6@5", 271600},
+    {1, 7, 6, "1:325>375,6:525>325@1,3:125>325,4:125>325,5:125>275,1:375>525@1,5:275>325@6@5", 317000},
+    {1, 7, 7, "", 15000},
+    {1, 7, 8, "1:325>375a,5:125>275,6:525>325@1,1:375>325@6@1,3:125>325,4:125>325,5:275>325@6@5", 286800},
+    {1, 7, 9, "1:325>375a,5:125>275,6:525>325@1,1:375>325@6@1,3:125>325,5:275>325@6@5", 241400},
+    {1, 7, 10, "0:325>525,1:325>525,2:325>525", 256200},
+    {1, 7, 11, "1:325>375,6:525>325@1,0:325>525,1:375>525@1,2:325>525", 301600},
+    {1, 8, 0, "1:325>375a,5:325>275a,6:325>525@1@5,1:375>325@6@1,5:275>325@6@5", 150800},
+    {1, 8, 1, "1:325>375a,5:325>275,6:325>525@1@5,0:325>525,1:375>325@6@1,3:325>125,4:325>125,5:275>125@5", 362200},
+    {1, 8, 2, "2:325>525,5:325>125", 195800},
+    {1, 8, 3, "4:325>125,5:325>125", 195800},
+    {1, 8, 4, "0:325>525,3:325>125,4:325>125", 256200},
+    {1, 8, 5, "1:325>525,4:325>125", 195800},
+    {1, 8, 6, "1:325>525", 135400},
+    {1, 8, 7, "1:325>375a,5:325>275,6:325>525@1@5,1:375>325@6@1,3:325>125,4:325>125,5:275>125@5", 286800},
+    {1, 8, 8, "", 15000},
+    {1, 8, 9, "4:325>125", 135400},
+    {1, 8, 10, "1:325>375,5:325>275,6:325>525@1@5,0:325>525,1:375>525@1,2:325>525,3:325>125,4:325>125,5:275>125@5", 482800},
+    {1, 8, 11, "0:325>525,1:325>525,2:325>525,3:325>125,4:325>125,5:325>125", 437400},
+    {1, 9, 0, "1:325>375a,5:325>275a,6:325>525@1@5,1:375>325@6@1,4:125>325,5:275>325@6@5", 211200},
+    {1, 9, 1, "1:325>375a,5:325>275,6:325>525@1@5,0:325>525,1:375>325@6@1,3:325>125,5:275>125@5", 286800},
+    {1, 9, 2, "2:325>525,4:125>325,5:325>125", 256200},
+    {1, 9, 3, "5:325>125", 135400},
+    {1, 9, 4, "0:325>525,3:325>125", 195800},
+    {1, 9, 5, "1:325>525", 135400},
+    {1, 9, 6, "1:325>525,4:125>325", 195800},
+    {1, 9, 7, "1:325>375a,5:325>275,6:325>525@1@5,1:375>325@6@1,3:325>125,5:275>125@5", 241400},
+    {1, 9, 8, "4:125>325", 135400},
+    {1, 9, 9, "", 15000},
+    {1, 9, 10, "1:325>375,5:325>275,6:325>525@1@5,0:325>525,1:375>525@1,2:325>525,3:325>125,5:275>125@5", 407400},
+    {1, 9, 11, "0:325>525,1:325>525,2:325>525,3:325>125,5:325>125", 317000},
+    {1, 10, 0, "0:525>325,1:525>325,2:525>325,3:125>325,4:125>325,5:125>325", 437400},
+    {1, 10, 1, "1:525>325,2:525>325", 195800},
+    {1, 10, 2, "1:525>375,6:525>325,0:525>325,1:375>325@6@1,3:125>325,4:125>325", 317000},
+    {1, 10, 3, "1:525>375,6:525>325,0:525>325,1:375>325@6@1,2:525>325,3:125>325", 317000},
+    {1, 10, 4, "1:525>375,5:125>275,6:525>325,1:375>325@6@1,2:525>325,5:275>325@6@5", 271600},
+    {1, 10, 5, "5:125>275,6:525>325,0:525>325,2:525>325,3:125>325,5:275>325@6@5", 317000},
+    {1, 10, 6, "6:525>325,0:525>325,2:525>325,3:125>325,4:125>325,5:125>275,5:275>325@6@5", 392400},
+    {1, 10, 7, "0:525>325,1:525>325,2:525>325", 256200},
+    {1, 10, 8, "6:525>325,0:525>325,2:525>325,3:125>325,4:125>325,1:525>375,5:125>275,1:375>325@6@1,5:275>325@6@5", 452800},
+    {1, 10, 9, "6:525>325,0:525>325,2:525>325,3:125>325,1:525>375,5:125>275,1:375>325@6@1,5:275>325@6@5", 392400},
+    {1, 10, 10, "", 15000},
+    {1, 10, 11, "6:525>325", 135400},
+    {1, 11, 0, "6:325>525,0:525>325,2:525>325,3:125>325,4:125>325,1:525>375,5:125>275,1:375>325@6@1,5:275>325@6@5", 452800},
+    {1, 11, 1, "1:525>375,6:325>525,1:375>325@6@1,2:525>325", 211200},
+    {1, 11, 2, "0:525>325,1:525>325,3:125>325,4:125>325", 316600},
+    {1, 11, 3, "0:525>325,1:525>325,2:525>325,3:125>325", 316600},
+    {1, 11, 4, "1:525>325,2:525>325,5:125>325", 256200},
+    {1, 11, 5, "0:525>325,2:525>325,3:125>325,5:125>325", 316600},
+    {1, 11, 6, "0:525>325,2:525>325,3:125>325,4:125>325,5:125>325", 317000},
+    {1, 11, 7, "1:525>375,6:325>525,0:525>325,1:375>325@6@1,2:525>325", 271600},
+    {1, 11, 8, "0:525>325,1:525>325,2:525>325,3:125>325,4:125>325,5:125>325", 437400},
+    {1, 11, 9, "0:525>325,1:525>325,2:525>325,3:125>325,5:125>325", 317000},
+    {1, 11, 10, "6:325>525", 135400},
+    {1, 11, 11, "", 15000},
+};
+
+#endif // MOTION_CORPUS_H
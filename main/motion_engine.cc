@@ -0,0 +1,259 @@
+#include "motion_engine.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <algorithm>
+
+// Script frame pools, one slice of a shared frame array each. A pool is normally used by
+// one task, but frames are freed by whoever destroys the engine, so slots are claimed with
+// compare-and-swap on a bitmap instead of a lock.
+namespace {
+
+#define POOL_FRAME_NUM (MOTION_CLOCK_FRAME_NUM + MOTION_BENCH_FRAME_NUM)
+#define POOL_WORDS ((POOL_FRAME_NUM + 31) / 32)
+
+// First slot of each pool, the last entry ends the array
+constexpr int kPoolFirst[MOTION_POOL_NUM + 1] = {0, MOTION_CLOCK_FRAME_NUM, POOL_FRAME_NUM};
+
+alignas(16) uint8_t pool_frames[POOL_FRAME_NUM][MOTION_SCRIPT_FRAME_SIZE];
+std::atomic<uint32_t> pool_used[POOL_WORDS];
+std::atomic<size_t> pool_largest_request{0};
+
+// Bits of word that fall inside [first, end)
+uint32_t WordMask(int word, int first, int end) {
+    int lo = std::max(first - word * 32, 0);
+    int hi = std::min(end - word * 32, 32);
+    uint32_t below_hi = (hi == 32) ? 0xFFFFFFFF : (1u << hi) - 1;
+    return below_hi & ~((1u << lo) - 1);
+}
+
+} // namespace
+
+void* MotionPoolAllocate(MotionPool pool, size_t size) {
+    size_t largest = pool_largest_request.load(std::memory_order_relaxed);
+    while (size > largest && !pool_largest_request.compare_exchange_weak(largest, size, std::memory_order_relaxed)) {
+    }
+    if (size > MOTION_SCRIPT_FRAME_SIZE) return nullptr;
+    const int first = kPoolFirst[pool];
+    const int end = kPoolFirst[pool + 1];
+    for (int word = first / 32; word * 32 < end; word++) {
+        const uint32_t mask = WordMask(word, first, end);
+        uint32_t used = pool_used[word].load(std::memory_order_relaxed);
+        while ((~used & mask) != 0) {
+            int bit = __builtin_ctz(~used & mask);
+            if (pool_used[word].compare_exchange_weak(used, used | (1u << bit), std::memory_order_acquire)) {
+                return pool_frames[word * 32 + bit];
+            }
+        }
+    }
+    return nullptr;
+}
+
+int MotionPoolFree(MotionPool pool) {
+    const int first = kPoolFirst[pool];
+    const int end = kPoolFirst[pool + 1];
+    int used = 0;
+    for (int word = first / 32; word * 32 < end; word++) {
+        used += __builtin_popcount(pool_used[word].load(std::memory_order_relaxed) & WordMask(word, first, end));
+    }
+    return end - first - used;
+}
+
+size_t MotionPoolLargestRequest() {
+    return pool_largest_request.load(std::memory_order_relaxed);
+}
+
+void MotionPoolRelease(void* frame) {
+    int slot = ((uint8_t*)frame - &pool_frames[0][0]) / MOTION_SCRIPT_FRAME_SIZE;
+    pool_used[slot / 32].fetch_and(~(1u << (slot % 32)), std::memory_order_release);
+}
+
+void MotionEvent::Set() {
+    set_ = true;
+    while (waiters_ != nullptr) {
+        Waiter* waiter = waiters_;
+        waiters_ = waiter->next;
+        waiter->engine->waiting_--;
+        waiter->engine->Resume(waiter->script);
+    }
+}
+
+void MotionEngine::DelayAwaiter::await_suspend(MotionScriptHandle script) {
+    Delayed delayed = {engine_.now_ms_ + ms_, script};
+    auto it = std::upper_bound(engine_.delayed_.begin(), engine_.delayed_.end(), delayed,
+                               [](const Delayed& a, const Delayed& b) { return a.wake_ms < b.wake_ms; });
+    engine_.delayed_.insert(it, delayed);
+}
+
+void MotionEngine::WaitAwaiter::await_suspend(MotionScriptHandle script) {
+    waiter_.script = script;
+    waiter_.next = event_.waiters_;
+    event_.waiters_ = &waiter_;
+    waiter_.engine->waiting_++;
+}
+
+MotionEngine::MotionEngine(MotionPool pool) : pool_(pool) {
+    // Reserve up front so scheduling itself does not allocate
+    scripts_.reserve(SERVO_CHANNEL_NUM * 2);
+    moves_.reserve(SERVO_CHANNEL_NUM);
+    plan_tasks_.reserve(SERVO_CHANNEL_NUM * 2);
+}
+
+MotionEngine::~MotionEngine() {
+    Clear();
+}
+
+int MotionEngine::AddScript(MotionScriptHandle script) {
+    scripts_.push_back(script);
+    return next_order_++;
+}
+
+void MotionEngine::StartMove(const MotionMove& move, MotionScriptHandle script, int* remaining) {
+    ActiveMove active = {script.promise().order, next_move_id_++, move.channel, move.from, move.to,
+                         move.step, script, remaining};
+    auto it = std::upper_bound(moves_.begin(), moves_.end(), active, [](const ActiveMove& a, const ActiveMove& b) {
+        return (a.order != b.order) ? a.order < b.order : a.id < b.id;
+    });
+    moves_.insert(it, active);
+}
+
+void MotionEngine::Resume(MotionScriptHandle script) {
+    script.resume();
+    resumed_ = true;
+}
+
+void MotionEngine::FreeFinishedScripts() {
+    // Scripts only finish while running, nothing to free when none was resumed
+    if (!resumed_) return;
+    resumed_ = false;
+    for (auto it = scripts_.begin(); it != scripts_.end(); ) {
+        if (it->done()) {
+            it->destroy();
+            it = scripts_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MotionEngine::Clear() {
+    for (auto& script : scripts_) {
+        script.destroy();
+    }
+    scripts_.clear();
+    moves_.clear();
+    delayed_.clear();
+    plan_tasks_.clear();
+    waiting_ = 0;
+}
+
+// GCC 12 at -O0 pairs the coroutine's pool operator new with the wrong delete and warns
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+MotionScript MotionEngine::RunPlanTask(MotionEngine& engine, ServoState task, PlanFronts fronts) {
+    // Registered before the first suspension, so moves added after this one can depend on it
+    MotionEvent done;
+    engine.plan_tasks_.push_back({task.channel, &done});
+
+    for (MotionEvent* front : fronts.events) {
+        if (front != nullptr) co_await engine.Wait(*front);
+    }
+    co_await engine.Move(task.channel, task.current_position, task.target_position, task.step);
+
+    auto it = std::find_if(engine.plan_tasks_.begin(), engine.plan_tasks_.end(),
+                           [&](const PlanTask& plan_task) { return plan_task.done == &done; });
+    engine.plan_tasks_.erase(it);
+    done.Set();
+}
+#pragma GCC diagnostic pop
+
+bool MotionEngine::AddTask(const ServoState& task) {
+    PlanFronts fronts = {};
+    int front_num = 0;
+
+    // First unfinished move of each front channel
+    for (int front_channel : task.front_channels) {
+        if (front_channel == -1) continue; // No dependency
+        for (const auto& plan_task : plan_tasks_) {
+            if (plan_task.channel == front_channel) {
+                fronts.events[front_num++] = plan_task.done;
+                break;
+            }
+        }
+    }
+
+    MotionScript script = RunPlanTask(*this, task, fronts);
+    if (!script.Started()) return false;
+
+    // A move with nothing to do finishes right away; it is the script just added
+    if (scripts_.back().done()) {
+        scripts_.back().destroy();
+        scripts_.pop_back();
+    }
+    return true;
+}
+
+MotionRound MotionEngine::RunRound(int* current_positions, MotionOutput& output) {
+    MotionRound round;
+
+    // Scripts whose delay is over continue first
+    while (!delayed_.empty() && delayed_.front().wake_ms <= now_ms_) {
+        MotionScriptHandle script = delayed_.front().script;
+        delayed_.erase(delayed_.begin());
+        Resume(script);
+    }
+
+    // Step moves in (order, id) order. Moves started during the round by resumed scripts
+    // are stepped in the same round when they sort after the last stepped move.
+    size_t index = 0;
+    while (index < moves_.size()) {
+        ActiveMove& move = moves_[index];
+
+        // Velocity limit: at most one step towards the target, the last step lands on it
+        move.position += std::max(-move.step, std::min(move.target - move.position, move.step));
+        bool arrived = move.position == move.target;
+
+        // Execute servo movement
+        output.WriteChannel(move.channel, move.position);
+        now_ms_ += SERVO_STEP_DELAY_MS;
+
+        if (arrived) {
+            current_positions[move.channel] = move.target; // Update current servo position
+            ActiveMove done = move;
+            moves_.erase(moves_.begin() + index);
+            if (--(*done.remaining) == 0) {
+                Resume(done.script); // Direct resumption, the script may start its next moves
+
+                // New moves can sort anywhere, continue after the move just stepped
+                auto it = std::find_if(moves_.begin(), moves_.end(), [&](const ActiveMove& next) {
+                    return (next.order != done.order) ? next.order > done.order : next.id > done.id;
+                });
+                index = it - moves_.begin();
+            }
+        } else {
+            index++;
+        }
+
+        // Check max concurrent moves
+        round.tasks_executed++;
+        if (round.tasks_executed >= MAX_SERVO_TASK_NUM) break;
+    }
+    FreeFinishedScripts();
+
+    // Scripts left waiting on an event that nothing can set any more would never finish
+    if (moves_.empty() && delayed_.empty() && waiting_ > 0) {
+        Clear();
+    }
+
+    round.tasks_remaining = round.tasks_executed > 0 || !scripts_.empty();
+    round.restart = round.tasks_executed >= MAX_SERVO_TASK_NUM || waiting_ > 0;
+    if (!round.restart) now_ms_ += SERVO_STEP_DELAY_MS; // Round delay taken by the caller
+    if (scripts_.empty()) {
+        // Nothing pending, restart the clock and the start order so they never wrap
+        now_ms_ = 0;
+        next_order_ = 0;
+        next_move_id_ = 0;
+    }
+    return round;
+}
@@ -0,0 +1,289 @@
+#ifndef MOTION_ENGINE_H
+#define MOTION_ENGINE_H
+
+#include <stdlib.h>
+#include <coroutine>
+#include <vector>
+#include "display_topology.h"
+
+// Motion engine shared by the firmware and the motion benchmark.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define SERVO_POSITION_MIN 100   // 实测有效范围是100~550
+#define SERVO_POSITION_MAX 550
+#define SERVO_STEP_SMOOTH 5      // Step size per write of the silent speed profile
+#define SERVO_STEP_NORMAL 20     // Normal speed profile
+#define SERVO_STEP_FAST 50       // Fast speed profile, the default step
+#define SERVO_STEP_INSTANT (SERVO_POSITION_MAX - SERVO_POSITION_MIN) // Any move in one write
+#define SERVO_STEP_DELAY_MS 15   // Delay after every PWM write and after every full round
+
+#define MAX_SERVO_TASK_NUM 5 // 同时运行的最大舵机任务数
+#define MAX_FRONT_CHANNELS 2 // 每个任务最多依赖的前置通道数
+
+// 协程帧从静态内存池分配，时钟任务和网页任务（/bench、语料检查）各用一个池，互不抢占
+#define MOTION_SCRIPT_FRAME_SIZE (48 * sizeof(void*)) // Bytes per coroutine frame, a plan move needs about 30 words
+#define MOTION_PLAN_MOVE_MAX (2 * SERVO_CHANNEL_NUM)  // A plan moves every servo at most twice
+#define MOTION_CLOCK_FRAME_NUM (2 * MOTION_PLAN_MOVE_MAX) // Plan being executed plus the estimate of the next one
+#define MOTION_BENCH_FRAME_NUM MOTION_PLAN_MOVE_MAX     // One simulated plan at a time
+
+// Frame pool an engine allocates its scripts from, one per task that runs engines
+enum MotionPool {
+    MOTION_POOL_CLOCK, // Clock task: the live engine and its plan estimates
+    MOTION_POOL_BENCH, // Web task: /bench and the corpus check
+    MOTION_POOL_NUM
+};
+
+// Frames still free in pool
+int MotionPoolFree(MotionPool pool);
+// Largest frame a script has asked for, it has to fit MOTION_SCRIPT_FRAME_SIZE. The compiler
+// decides the frame size, so the corpus check tests it instead of a static_assert.
+size_t MotionPoolLargestRequest();
+
+void* MotionPoolAllocate(MotionPool pool, size_t size);
+void MotionPoolRelease(void* frame);
+
+struct ServoState {
+    int channel;            // Servo channel
+    int current_position;   // Current servo position
+    int target_position;    // Target servo position
+    int front_channels[MAX_FRONT_CHANNELS] = {-1, -1}; // Preceding task channels, -1 means no dependency
+    int step = SERVO_STEP_FAST; // Position change per write (speed profile)
+    bool avoidance = false; // Move only clears the way for another arm
+};
+
+// Receives every PWM position produced by the engine
+class MotionOutput {
+public:
+    virtual ~MotionOutput() = default;
+    virtual void WriteChannel(int channel, int position) = 0;
+};
+
+// Result of one pass over the moving servos
+struct MotionRound {
+    bool tasks_remaining = false; // Unfinished moves or scripts remain after this round
+    bool restart = false;         // Task limit reached or a script is waiting, next round starts without the round delay
+    int tasks_executed = 0;       // Number of PWM writes in this round
+};
+
+class MotionEngine;
+
+// Return type of motion scripts, C++20 coroutines such as
+//
+//     MotionScript Example(MotionEngine& engine) {
+//         co_await engine.Move(6, 300, 110);
+//         co_await engine.All(MotionMove{1, 230, 110}, MotionMove{5, 190, 310});
+//         co_await engine.Delay(500);
+//     }
+//
+// The first parameter of a script is the engine it runs on. Calling a script starts it
+// immediately; it runs until its first co_await and is owned by the engine from then on.
+// Frames come from the engine's static pool, Started() is false when it was exhausted.
+class MotionScript {
+public:
+    struct promise_type {
+        template <typename... Args>
+        promise_type(MotionEngine& engine, const Args&...);
+
+        // Frames come from the pool of the engine the script runs on, its first parameter
+        template <typename... Args>
+        static void* operator new(size_t size, MotionEngine& engine, const Args&...) noexcept;
+        static void operator delete(void* frame) noexcept { MotionPoolRelease(frame); }
+        static MotionScript get_return_object_on_allocation_failure() { return MotionScript(false); }
+
+        MotionScript get_return_object() { return MotionScript(true); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; } // Engine frees the frame
+        void return_void() {}
+        void unhandled_exception() { abort(); } // Built without exceptions
+
+        int order = 0; // Start order, moves of earlier scripts are stepped first
+    };
+
+    bool Started() const { return started_; }
+
+private:
+    explicit MotionScript(bool started) : started_(started) {}
+    bool started_;
+};
+
+using MotionScriptHandle = std::coroutine_handle<MotionScript::promise_type>;
+
+// One servo move inside a script
+struct MotionMove {
+    int channel;
+    int from;
+    int to;
+    int step = SERVO_STEP_FAST;
+};
+
+// Completion flag a script can wait on with engine.Wait(event)
+class MotionEvent {
+public:
+    MotionEvent() = default;
+    MotionEvent(const MotionEvent&) = delete;
+    MotionEvent& operator=(const MotionEvent&) = delete;
+
+    bool IsSet() const { return set_; }
+    void Set(); // Resumes every waiting script right away
+
+private:
+    friend class MotionEngine;
+    struct Waiter {
+        MotionEngine* engine;
+        MotionScriptHandle script;
+        Waiter* next;
+    };
+    bool set_ = false;
+    Waiter* waiters_ = nullptr;
+};
+
+// Cooperative scheduler for motion scripts. Servos only move inside RunRound; a script
+// suspended on a move, an event or a delay is resumed directly when that completes, no
+// task list is rescanned. Every write costs SERVO_STEP_DELAY_MS, as do rounds that end
+// without restart, and that time is the engine's clock for Delay().
+class MotionEngine {
+public:
+    // Waits until all N moves have reached their targets (moves with from == to are skipped).
+    // The moves are held by value: GCC cannot keep an initializer_list across a co_await.
+    template <int N>
+    class MoveAwaiter {
+    public:
+        template <typename... Moves>
+        MoveAwaiter(MotionEngine& engine, const Moves&... moves) : engine_(engine), moves_{moves...} {}
+
+        bool await_ready() {
+            remaining_ = 0;
+            for (const MotionMove& move : moves_) {
+                if (move.from != move.to) remaining_++;
+            }
+            return remaining_ == 0;
+        }
+        void await_suspend(MotionScriptHandle script) {
+            for (const MotionMove& move : moves_) {
+                if (move.from != move.to) engine_.StartMove(move, script, &remaining_);
+            }
+        }
+        void await_resume() {}
+
+    private:
+        MotionEngine& engine_;
+        MotionMove moves_[N];
+        int remaining_ = 0;
+    };
+
+    class DelayAwaiter {
+    public:
+        DelayAwaiter(MotionEngine& engine, int ms) : engine_(engine), ms_(ms) {}
+        bool await_ready() const { return ms_ <= 0; }
+        void await_suspend(MotionScriptHandle script);
+        void await_resume() {}
+
+    private:
+        MotionEngine& engine_;
+        int ms_;
+    };
+
+    class WaitAwaiter {
+    public:
+        WaitAwaiter(MotionEngine& engine, MotionEvent& event) : event_(event), waiter_{&engine, {}, nullptr} {}
+        bool await_ready() const { return event_.IsSet(); }
+        void await_suspend(MotionScriptHandle script);
+        void await_resume() {}
+
+    private:
+        MotionEvent& event_;
+        MotionEvent::Waiter waiter_;
+    };
+
+    explicit MotionEngine(MotionPool pool = MOTION_POOL_CLOCK);
+    ~MotionEngine();
+    MotionEngine(const MotionEngine&) = delete;
+    MotionEngine& operator=(const MotionEngine&) = delete;
+
+    // Script primitives
+    MoveAwaiter<1> Move(int channel, int from, int to, int step = SERVO_STEP_FAST) {
+        return MoveAwaiter<1>(*this, MotionMove{channel, from, to, step});
+    }
+    template <typename... Moves>
+    MoveAwaiter<sizeof...(Moves)> All(const Moves&... moves) {
+        return MoveAwaiter<sizeof...(Moves)>(*this, moves...);
+    }
+    DelayAwaiter Delay(int ms) { return DelayAwaiter(*this, ms); }
+    WaitAwaiter Wait(MotionEvent& event) { return WaitAwaiter(*this, event); }
+
+    // Run a planned move as a script. It waits for the first unfinished move of each
+    // front channel. Returns false when no script frame was free; later moves would not
+    // wait for the missing one, so the caller has to drop the whole plan (Clear()).
+    bool AddTask(const ServoState& task);
+
+    void Clear();
+    MotionPool Pool() const { return pool_; }
+    bool Empty() const { return scripts_.empty(); }
+    int ScriptsAlive() const { return scripts_.size(); }
+    int MovesActive() const { return moves_.size(); }
+
+    // Run one round: step at most MAX_SERVO_TASK_NUM moving servos, earliest script first.
+    // current_positions[channel] is updated when a move reaches its target.
+    MotionRound RunRound(int* current_positions, MotionOutput& output);
+
+    // Take ownership of a script that has just been created, returns its start order
+    int AddScript(MotionScriptHandle script);
+
+private:
+    friend class MotionEvent;
+
+    struct ActiveMove {
+        int order;      // Script start order
+        int id;         // Issue order, breaks ties inside a script
+        int channel;
+        int position;
+        int target;
+        int step;
+        MotionScriptHandle script;
+        int* remaining; // Moves the script still waits for
+    };
+
+    struct Delayed {
+        int wake_ms;
+        MotionScriptHandle script;
+    };
+
+    // Unfinished move started through AddTask
+    struct PlanTask {
+        int channel;
+        MotionEvent* done;
+    };
+
+    // Events a planned move waits for, nullptr for none
+    struct PlanFronts {
+        MotionEvent* events[MAX_FRONT_CHANNELS];
+    };
+
+    static MotionScript RunPlanTask(MotionEngine& engine, ServoState task, PlanFronts fronts);
+    void StartMove(const MotionMove& move, MotionScriptHandle script, int* remaining);
+    void Resume(MotionScriptHandle script);
+    void FreeFinishedScripts();
+
+    const MotionPool pool_;
+    std::vector<MotionScriptHandle> scripts_; // Scripts alive, owned by the engine
+    std::vector<ActiveMove> moves_;           // Sorted by (order, id)
+    std::vector<Delayed> delayed_;
+    std::vector<PlanTask> plan_tasks_;        // In AddTask order
+    int next_order_ = 0;
+    int next_move_id_ = 0;
+    int waiting_ = 0;  // Scripts suspended on an event
+    bool resumed_ = false; // A script ran since the last FreeFinishedScripts
+    int now_ms_ = 0;   // Engine clock
+};
+
+template <typename... Args>
+void* MotionScript::promise_type::operator new(size_t size, MotionEngine& engine, const Args&...) noexcept {
+    return MotionPoolAllocate(engine.Pool(), size);
+}
+
+template <typename... Args>
+MotionScript::promise_type::promise_type(MotionEngine& engine, const Args&...) {
+    order = engine.AddScript(MotionScriptHandle::from_promise(*this));
+}
+
+#endif // MOTION_ENGINE_H
@@ -0,0 +1,48 @@
+#include "motion_kernel.h"
+
+void InterpolatePositionsScalar(const int16_t* from, const int16_t* to, int fraction,
+                                int16_t lo, int16_t hi, int16_t* out, int n) {
+    if (fraction >= MOTION_Q15_ONE) {
+        from = to; // Fraction 1.0 does not fit a 16-bit lane, land on to with fraction 0
+        fraction = 0;
+    }
+    for (int i = 0; i < n; i++) {
+        int position = from[i] + (((to[i] - from[i]) * fraction) >> 15);
+        if (position < lo) position = lo;
+        if (position > hi) position = hi;
+        out[i] = position;
+    }
+}
+
+#if MOTION_KERNEL_PIE
+
+// motion_kernel_pie.S
+extern "C" void MotionKernelInterpolatePie(const int16_t* from, const int16_t* to, int16_t* out,
+                                           const int16_t* params, int vectors);
+
+void InterpolatePositions(const int16_t* from, const int16_t* to, int fraction,
+                          int16_t lo, int16_t hi, int16_t* out, int n) {
+    if (fraction >= MOTION_Q15_ONE) {
+        from = to;
+        fraction = 0;
+    }
+    const int16_t params[3] = {(int16_t)fraction, lo, hi}; // Broadcast into every lane
+    MotionKernelInterpolatePie(from, to, out, params, n / MOTION_LANES);
+}
+
+const char* MotionKernelName() {
+    return "pie";
+}
+
+#else
+
+void InterpolatePositions(const int16_t* from, const int16_t* to, int fraction,
+                          int16_t lo, int16_t hi, int16_t* out, int n) {
+    InterpolatePositionsScalar(from, to, fraction, lo, hi, out, n);
+}
+
+const char* MotionKernelName() {
+    return "scalar";
+}
+
+#endif
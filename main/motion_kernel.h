@@ -0,0 +1,44 @@
+#ifndef MOTION_KERNEL_H
+#define MOTION_KERNEL_H
+
+#include <stdint.h>
+#include "display_topology.h"
+
+// Per-frame position kernels. Built with MOTION_KERNEL_PIE (an opt-in CMake option for the
+// ESP32-S3) they run on the PIE vector unit, eight 16-bit lanes per instruction; otherwise
+// the scalar version runs. Both give bit-identical results.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define MOTION_LANES 8           // int16 lanes in one 128-bit vector
+#define MOTION_LANE_ALIGN 16     // Kernel arrays start on a vector boundary
+#define MOTION_PADDED(n) (((n) + MOTION_LANES - 1) / MOTION_LANES * MOTION_LANES)
+#define SERVO_LANE_NUM MOTION_PADDED(SERVO_CHANNEL_NUM) // Channel arrays padded to whole vectors
+#define MOTION_Q15_ONE 32768     // Fraction 1.0
+
+// out[i] = clamp(from[i] + ((to[i] - from[i]) * fraction >> 15), lo, hi) for i < n.
+// fraction runs from 0 to MOTION_Q15_ONE; the shift rounds towards minus infinity.
+// n must be a multiple of MOTION_LANES and every array MOTION_LANE_ALIGN aligned.
+void InterpolatePositions(const int16_t* from, const int16_t* to, int fraction,
+                          int16_t lo, int16_t hi, int16_t* out, int n);
+
+// Scalar version, always available (reference for the benchmark)
+void InterpolatePositionsScalar(const int16_t* from, const int16_t* to, int fraction,
+                                int16_t lo, int16_t hi, int16_t* out, int n);
+
+// "pie" or "scalar", the version InterpolatePositions runs
+const char* MotionKernelName();
+
+// CPU cycle counter for the kernel benchmarks, 0 where there is none
+inline uint32_t MotionCycleCount() {
+#if defined(__XTENSA__)
+    uint32_t ccount;
+    asm volatile("rsr.ccount %0" : "=r"(ccount));
+    return ccount;
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+#endif // MOTION_KERNEL_H
@@ -0,0 +1,294 @@
+#include "motion_planner.h"
+
+#include <stdlib.h>
+#include <algorithm>
+
+const int kGlyphSegments[GLYPH_NUM][SEGMENTS_PER_DIGIT] = {
+    {1, 1, 1, 1, 1, 1, 0}, {0, 1, 1, 0, 0, 0, 0},
+    {1, 1, 0, 1, 1, 0, 1}, {1, 1, 1, 1, 0, 0, 1},
+    {0, 1, 1, 0, 0, 1, 1}, {1, 0, 1, 1, 0, 1, 1},
+    {1, 0, 1, 1, 1, 1, 1}, {1, 1, 1, 0, 0, 0, 0},
+    {1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 0, 1, 1},
+    {0, 0, 0, 0, 0, 0, 0}, // 0xA 全关
+    {0, 0, 0, 0, 0, 0, 1}  // 0xB idle
+};
+
+const ServoProfile kServoProfiles[2] = {
+    {
+        "A",
+        { 110, 110, 120, 330, 330, 310, 110},
+        { 300, 300, 310, 140, 140, 120, 300},
+        {
+            // 中间指针扫过时，1、5 号指针需要避让 120
+            {6, 1, 60, 130, 100, 120},
+            {6, 5, 60, 130, 100, 120},
+        },
+        2,
+    },
+    {
+        "B",
+        { 325, 325, 325, 325, 325, 325, 325},
+        { 525, 525, 525, 125, 125, 125, 525},
+        {
+            // New version: smaller avoidance distance
+            {6, 1, 60, 140, 40, 50},
+            {6, 5, 60, 140, 40, 50},
+        },
+        2,
+    },
+};
+
+void GetGlyphTargets(const ServoProfile& profile, const int* offsets, const int* glyphs, int* target) {
+    for (int digit = 0; digit < CLOCK_DIGIT_NUM; digit++) {
+        for (int i = 0; i < SEGMENTS_PER_DIGIT; i++) {
+            int ch = digit * SEGMENTS_PER_DIGIT + i;
+            int position = GlyphSegmentOn(glyphs[digit], i) ? profile.segment_on[i] : profile.segment_off[i];
+            position += offsets[ch];
+
+            // Check for out-of-range values
+            if (position < SERVO_POSITION_MIN) position = SERVO_POSITION_MIN;
+            if (position > SERVO_POSITION_MAX) position = SERVO_POSITION_MAX;
+            target[ch] = position;
+        }
+    }
+}
+
+void PlanDisplayTransition(const ServoProfile& profile, const int* offsets, const int* current,
+                           const int* glyphs, int step,
+                           int* target, std::vector<ServoState>& plan) {
+    GetGlyphTargets(profile, offsets, glyphs, target);
+
+    auto AddMove = [&](int ch, int start_position, int to_position, const int* fronts, bool avoidance) {
+        ServoState task = {ch, start_position, to_position, {fronts[0], fronts[1]}, step, avoidance};
+        plan.push_back(task);
+    };
+
+    auto AddFront = [](int* fronts, int channel) {
+        for (int i = 0; i < MAX_FRONT_CHANNELS; i++) {
+            if (fronts[i] == -1 || fronts[i] == channel) {
+                fronts[i] = channel;
+                return;
+            }
+        }
+    };
+
+    auto ProcessDigit = [&](int base_channel) {
+        int on[SEGMENTS_PER_DIGIT], dir[SEGMENTS_PER_DIGIT];
+        for (int i = 0; i < SEGMENTS_PER_DIGIT; i++) {
+            on[i] = profile.segment_on[i] + offsets[base_channel + i];
+            dir[i] = (profile.segment_off[i] > profile.segment_on[i]) ? 1 : -1;
+        }
+        auto Depth = [&](int seg, int position) { return (position - on[seg]) * dir[seg]; };
+
+        int first_position[SEGMENTS_PER_DIGIT];     // Move made before the movers, -1 means none
+        bool first_avoidance[SEGMENTS_PER_DIGIT] = {false}; // First move is a detour that has to be undone
+        bool is_mover[SEGMENTS_PER_DIGIT] = {false};
+        int main_fronts[SEGMENTS_PER_DIGIT][MAX_FRONT_CHANNELS];
+        const int no_fronts[MAX_FRONT_CHANNELS] = {-1, -1};
+        for (int i = 0; i < SEGMENTS_PER_DIGIT; i++) {
+            first_position[i] = -1;
+            for (int j = 0; j < MAX_FRONT_CHANNELS; j++) {
+                main_fronts[i][j] = -1;
+            }
+        }
+
+        for (int k = 0; k < profile.conflict_num; k++) {
+            const ArmConflict& conflict = profile.conflicts[k];
+            int m = conflict.mover;
+            int b = conflict.blocker;
+            int m_ch = base_channel + m;
+            int b_ch = base_channel + b;
+            if (current[m_ch] == target[m_ch]) continue;
+
+            // Does the mover sweep through the blocker's tip?
+            int from = Depth(m, current[m_ch]);
+            int to = Depth(m, target[m_ch]);
+            if (std::max(from, to) < conflict.sweep_lo || std::min(from, to) > conflict.sweep_hi) continue;
+            is_mover[m] = true;
+
+            int depth_now = Depth(b, current[b_ch]);
+            int depth_after = Depth(b, target[b_ch]);
+            int park_position = on[b] + dir[b] * conflict.clearance;
+            if (depth_now < conflict.block_depth && depth_after >= conflict.block_depth) {
+                // Leaving anyway: the mover only waits until the blocker is clear,
+                // the rest of the way runs in parallel with the mover
+                first_position[b] = (depth_after > conflict.clearance) ? park_position : target[b_ch];
+                AddFront(main_fronts[m], b_ch);
+            } else if (depth_now < conflict.block_depth) {
+                // Park at the clearance depth, come back once the mover has passed
+                if (first_position[b] == -1 || Depth(b, first_position[b]) < conflict.clearance) {
+                    first_position[b] = park_position;
+                }
+                first_avoidance[b] = true;
+                AddFront(main_fronts[m], b_ch);
+                AddFront(main_fronts[b], m_ch);
+            } else if (depth_after < conflict.block_depth) {
+                // Heading into the mover's way: come as close as the clearance depth,
+                // the last part waits until the mover has passed
+                if (depth_now > conflict.clearance) {
+                    first_position[b] = park_position;
+                }
+                AddFront(main_fronts[b], m_ch);
+            }
+        }
+
+        // 1. Blockers get out of the way, arms heading in come up to the clearance depth
+        for (int i = 0; i < SEGMENTS_PER_DIGIT; i++) {
+            int ch = base_channel + i;
+            if (first_position[i] != -1 && !is_mover[i]) {
+                AddMove(ch, current[ch], first_position[i], no_fronts, first_avoidance[i]);
+            }
+        }
+
+        // 2. Movers sweep across
+        for (int i = 0; i < SEGMENTS_PER_DIGIT; i++) {
+            int ch = base_channel + i;
+            if (is_mover[i]) {
+                AddMove(ch, current[ch], target[ch], main_fronts[i], false);
+            }
+        }
+
+        // 3. Everything else, parked blockers return and split moves finish
+        for (int i = 0; i < SEGMENTS_PER_DIGIT; i++) {
+            int ch = base_channel + i;
+            if (is_mover[i]) continue;
+            int start_position = (first_position[i] != -1) ? first_position[i] : current[ch];
+            if (start_position != target[ch]) {
+                // The second half of a split move waits for the first, they share one servo
+                if (first_position[i] != -1) {
+                    AddFront(main_fronts[i], ch);
+                }
+                AddMove(ch, start_position, target[ch], main_fronts[i], false);
+            }
+        }
+    };
+
+    // Digits left to right (hour tens first), each planned on its own
+    for (int digit = 0; digit < CLOCK_DIGIT_NUM; digit++) {
+        ProcessDigit(digit * SEGMENTS_PER_DIGIT);
+    }
+}
+
+namespace {
+
+class NullOutput : public MotionOutput {
+public:
+    void WriteChannel(int, int) override { writes++; }
+    int writes = 0;
+};
+
+// Order candidates for OptimizeMoveOrder
+enum MoveOrderKey {
+    ORDER_LEVEL_LONG_FIRST,  // Longest chain first, longer move on ties
+    ORDER_LEVEL_SHORT_FIRST, // Longest chain first, shorter move on ties
+    ORDER_LONG_FIRST,        // Longest move first
+};
+
+} // namespace
+
+int EstimatePlanTimeMs(const std::vector<ServoState>& plan, MotionPool pool) {
+    int positions[SERVO_CHANNEL_NUM];
+    for (const auto& task : plan) {
+        positions[task.channel] = task.current_position;
+    }
+
+    MotionEngine engine(pool);
+    for (const auto& task : plan) {
+        if (!engine.AddTask(task)) return -1; // A dropped move would make the plan look faster
+    }
+
+    // Same delays as ExecuteTask: one per PWM write, one per round that did not restart
+    int time_ms = 0;
+    bool tasks_remaining = true;
+    while (tasks_remaining) {
+        NullOutput output;
+        MotionRound round = engine.RunRound(positions, output);
+        tasks_remaining = round.tasks_remaining;
+        time_ms += output.writes * SERVO_STEP_DELAY_MS;
+        if (!round.restart) time_ms += SERVO_STEP_DELAY_MS;
+    }
+    return time_ms;
+}
+
+void OptimizeMoveOrder(std::vector<ServoState>& plan, MotionPool pool) {
+    const int n = plan.size();
+    if (n < 2) return;
+
+    // Engine steps needed by each move
+    std::vector<int> steps(n);
+    for (int i = 0; i < n; i++) {
+        steps[i] = (abs(plan[i].target_position - plan[i].current_position) + plan[i].step - 1) / plan[i].step;
+    }
+
+    // Predecessors as the engine resolves them: the first earlier move of each front
+    // channel. The second half of a split move names its own channel, so it stays
+    // behind the first half.
+    std::vector<std::vector<int>> preds(n);
+    for (int i = 0; i < n; i++) {
+        for (int front_channel : plan[i].front_channels) {
+            if (front_channel == -1) continue;
+            for (int j = 0; j < i; j++) {
+                if (plan[j].channel == front_channel) {
+                    preds[i].push_back(j);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Bottom level: steps from the start of a move to the end of its longest chain.
+    // Predecessors always come earlier in the list, so one backward pass is enough.
+    std::vector<int> level(steps);
+    for (int i = n - 1; i >= 0; i--) {
+        for (int j : preds[i]) {
+            level[j] = std::max(level[j], steps[j] + level[i]);
+        }
+    }
+
+    // List scheduling: repeatedly take the ready move that ranks highest under key
+    auto Schedule = [&](MoveOrderKey key) {
+        auto Before = [&](int i, int j) {
+            if (key == ORDER_LONG_FIRST) return steps[i] > steps[j];
+            if (level[i] != level[j]) return level[i] > level[j];
+            return (key == ORDER_LEVEL_LONG_FIRST) ? steps[i] > steps[j] : steps[i] < steps[j];
+        };
+
+        std::vector<ServoState> ordered;
+        ordered.reserve(n);
+        std::vector<bool> placed(n, false);
+        for (int count = 0; count < n; count++) {
+            int best = -1;
+            for (int i = 0; i < n; i++) {
+                if (placed[i]) continue;
+                bool ready = true;
+                for (int j : preds[i]) {
+                    if (!placed[j]) {
+                        ready = false;
+                        break;
+                    }
+                }
+                if (ready && (best == -1 || Before(i, best))) {
+                    best = i;
+                }
+            }
+            placed[best] = true;
+            ordered.push_back(plan[best]);
+        }
+        return ordered;
+    };
+
+    // Keep the candidate the engine finishes first, the planner's own order wins ties.
+    // plan stays in the planner's order until the end, preds index into it.
+    int best_time_ms = EstimatePlanTimeMs(plan, pool);
+    if (best_time_ms < 0) return;
+    std::vector<ServoState> best_plan;
+    for (MoveOrderKey key : {ORDER_LEVEL_LONG_FIRST, ORDER_LEVEL_SHORT_FIRST, ORDER_LONG_FIRST}) {
+        std::vector<ServoState> candidate = Schedule(key);
+        int time_ms = EstimatePlanTimeMs(candidate, pool);
+        if (time_ms >= 0 && time_ms < best_time_ms) {
+            best_time_ms = time_ms;
+            best_plan.swap(candidate);
+        }
+    }
+    if (!best_plan.empty()) plan.swap(best_plan);
+}
@@ -0,0 +1,80 @@
+#ifndef MOTION_PLANNER_H
+#define MOTION_PLANNER_H
+
+#include <vector>
+#include "motion_engine.h"
+
+// Display glyphs and transition planning, shared by the firmware and the motion benchmark.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define GLYPH_NUM 12
+#define GLYPH_OFF 0xA  // 全关
+#define GLYPH_IDLE 0xB // idle
+#define GLYPH_SEGMENT_FLAG 0x100 // 其余字形：低 7 位是亮的段，bit 0 为 a 段（见 segment_font.h）
+
+#define SERVO_PROFILE_A 0
+#define SERVO_PROFILE_B 1
+
+// 数字显示配置
+extern const int kGlyphSegments[GLYPH_NUM][SEGMENTS_PER_DIGIT];
+
+// Glyph lighting exactly the segments in mask
+constexpr int SegmentGlyph(int mask) { return GLYPH_SEGMENT_FLAG | (mask & 0x7F); }
+
+inline bool GlyphSegmentOn(int glyph, int segment) {
+    if (glyph & GLYPH_SEGMENT_FLAG) return (glyph >> segment) & 1;
+    return kGlyphSegments[glyph][segment] != 0;
+}
+
+#define MAX_ARM_CONFLICTS 4
+
+// 指针碰撞模型：mover 扫过 [sweep_lo, sweep_hi] 时，若 blocker 的深度小于 block_depth 就会相撞。
+// 深度以指针的亮位为 0、朝灭位方向为正（舵机计数），对每一位数字都相同。
+struct ArmConflict {
+    int mover;       // Segment (0..6) of the sweeping arm
+    int blocker;     // Segment of the arm that can be in its way
+    int sweep_lo;    // Mover depths that pass the blocker's tip
+    int sweep_hi;
+    int block_depth; // Blocker collides while shallower than this
+    int clearance;   // Depth the blocker is parked at when it has to come back afterwards
+};
+
+// 舵机位置参数，实测有效范围是100~550，中间值是325。每一位数字的同一段位置相同
+struct ServoProfile {
+    const char* name;
+    int segment_on[SEGMENTS_PER_DIGIT];
+    int segment_off[SEGMENTS_PER_DIGIT];
+    ArmConflict conflicts[MAX_ARM_CONFLICTS];
+    int conflict_num;
+
+    int OnPosition(int channel) const { return segment_on[channel % SEGMENTS_PER_DIGIT]; }
+    int OffPosition(int channel) const { return segment_off[channel % SEGMENTS_PER_DIGIT]; }
+};
+
+extern const ServoProfile kServoProfiles[2];
+
+// Fill target[SERVO_CHANNEL_NUM] with the clamped positions that show glyphs[CLOCK_DIGIT_NUM]
+void GetGlyphTargets(const ServoProfile& profile, const int* offsets, const int* glyphs, int* target);
+
+// Plan the moves from current[] to the positions showing glyphs[CLOCK_DIGIT_NUM].
+// Arms that would collide are ordered through the profile's conflict model: a blocker is
+// moved out of the way (straight to its target when that is clear, else parked at the
+// clearance depth and restored afterwards), or waits for the mover when it is heading in.
+// Moves are appended to plan in execution order; target[] receives the final positions.
+void PlanDisplayTransition(const ServoProfile& profile, const int* offsets, const int* current,
+                           const int* glyphs, int step,
+                           int* target, std::vector<ServoState>& plan);
+
+// Modelled makespan of plan from the engine's step and round delays (I2C time excluded).
+// Runs plan on an engine drawing from pool; -1 when the pool could not hold it.
+int EstimatePlanTimeMs(const std::vector<ServoState>& plan, MotionPool pool = MOTION_POOL_CLOCK);
+
+// Reorder plan so the engine's MAX_SERVO_TASK_NUM window stays full: moves heading the
+// longest remaining chain of steps start first, short moves fill the gaps. A few list
+// schedules are built and the one EstimatePlanTimeMs rates fastest is kept, so the
+// result is never slower than the planner's own order. Dependencies (front channels
+// and successive moves of one channel) keep their order. Left as it is when pool cannot
+// hold the plan.
+void OptimizeMoveOrder(std::vector<ServoState>& plan, MotionPool pool = MOTION_POOL_CLOCK);
+
+#endif // MOTION_PLANNER_H
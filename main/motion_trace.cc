@@ -0,0 +1,65 @@
+#include "motion_trace.h"
+
+#include <string.h>
+#include <new>
+#include <algorithm>
+
+MotionTrace::~MotionTrace() {
+    delete[] records_;
+}
+
+bool MotionTrace::Enable(bool enable) {
+    if (!enable) {
+        enabled_.store(false);
+        return true;
+    }
+    if (records_ == nullptr) {
+        records_ = new (std::nothrow) TraceRecord[TRACE_RECORD_NUM];
+        if (records_ == nullptr) return false;
+    }
+    enabled_.store(false);
+    head_.store(0);
+    skipped_.store(0);
+    enabled_.store(true);
+    return true;
+}
+
+void MotionTrace::Append(const TraceRecord& record) {
+    if (exporting_.load(std::memory_order_acquire)) {
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    records_[head % TRACE_RECORD_NUM] = record;
+    head_.store(head + 1, std::memory_order_release);
+}
+
+uint32_t MotionTrace::Count() const {
+    return std::min<uint32_t>(head_.load(std::memory_order_acquire), TRACE_RECORD_NUM - 1);
+}
+
+uint32_t MotionTrace::Dropped() const {
+    return head_.load(std::memory_order_acquire) - Count() + skipped_.load(std::memory_order_relaxed);
+}
+
+size_t MotionTrace::Export(uint8_t* out, size_t size) {
+    if (records_ == nullptr || size < sizeof(TraceHeader)) return 0;
+
+    // A record that started before the pause may still be landing in slot head % TRACE_RECORD_NUM,
+    // which is the oldest slot of a full ring; Count() never includes it
+    exporting_.store(true, std::memory_order_seq_cst);
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    uint32_t count = std::min<uint32_t>(head, TRACE_RECORD_NUM - 1);
+    count = std::min<uint32_t>(count, (size - sizeof(TraceHeader)) / sizeof(TraceRecord));
+
+    TraceHeader header = {TRACE_MAGIC, TRACE_VERSION, sizeof(TraceRecord), count,
+                          head - count + skipped_.load(std::memory_order_relaxed)};
+    memcpy(out, &header, sizeof(header));
+    uint8_t* dest = out + sizeof(header);
+    for (uint32_t i = head - count; i != head; i++) {
+        memcpy(dest, &records_[i % TRACE_RECORD_NUM], sizeof(TraceRecord));
+        dest += sizeof(TraceRecord);
+    }
+    exporting_.store(false, std::memory_order_release);
+    return dest - out;
+}
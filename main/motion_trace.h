@@ -0,0 +1,90 @@
+#ifndef MOTION_TRACE_H
+#define MOTION_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "motion_engine.h"
+
+// Opt-in record of every commanded servo position, kept in a ring buffer and downloaded
+// as a compact binary file (GET /trace?download=1) for tools/trace_replay.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define TRACE_RECORD_NUM 2048     // Ring capacity, 32 KB allocated when recording first starts
+#define TRACE_MAGIC 0x52544343    // "CCTR" little endian
+#define TRACE_VERSION 2           // 2: TRACE_PLAN records carry the step size
+
+// Why a position was commanded
+enum TraceReason : uint8_t {
+    TRACE_PLAN = 1,  // Planned move handed to the engine: from -> position, fronts, flags
+    TRACE_STEP,      // Engine step written to the servo
+    TRACE_FRAME,     // Animation frame written to the servo
+};
+
+#define TRACE_REASON_MASK 0x0F
+#define TRACE_FLAG_AVOIDANCE 0x20  // TRACE_PLAN: avoidance move
+
+// One record, 16 bytes, stored little endian as is
+struct TraceRecord {
+    uint32_t time_ms;   // Milliseconds since boot
+    uint16_t position;  // Commanded (TRACE_PLAN: target) position
+    uint16_t from;      // TRACE_PLAN: start position, otherwise 0
+    uint8_t channel;
+    uint8_t reason;     // TraceReason | TRACE_FLAG_*
+    int8_t fronts[MAX_FRONT_CHANNELS]; // TRACE_PLAN: front channels, -1 for none
+    uint16_t step;      // TRACE_PLAN: position change per write (speed profile), otherwise 0
+    uint16_t reserved;
+};
+static_assert(sizeof(TraceRecord) == 16, "Trace records are 16 bytes");
+
+// File header, followed by record_num records, oldest first
+struct TraceHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t record_num;
+    uint32_t dropped;   // Records overwritten or skipped, lost before the oldest one in the file
+};
+static_assert(sizeof(TraceHeader) == 16, "Trace header is 16 bytes");
+
+// Single writer (the clock task), any reader. Recording costs one branch while disabled
+// and a 16-byte store while enabled. Export pauses recording while it copies and leaves
+// out the slot a record may still be written to, so the file never holds a torn record.
+class MotionTrace {
+public:
+    ~MotionTrace();
+
+    // Starting clears the ring, stopping keeps it for download. False if the ring could not be allocated.
+    bool Enable(bool enable);
+    bool Enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void RecordPlan(uint32_t time_ms, const ServoState& task) {
+        if (!Enabled()) return;
+        uint8_t flags = task.avoidance ? TRACE_FLAG_AVOIDANCE : 0;
+        Append({time_ms, (uint16_t)task.target_position, (uint16_t)task.current_position, (uint8_t)task.channel,
+                (uint8_t)(TRACE_PLAN | flags), {(int8_t)task.front_channels[0], (int8_t)task.front_channels[1]},
+                (uint16_t)task.step, 0});
+    }
+    void RecordPosition(uint32_t time_ms, int channel, int position, TraceReason reason) {
+        if (!Enabled()) return;
+        Append({time_ms, (uint16_t)position, 0, (uint8_t)channel, reason, {-1, -1}, 0, 0});
+    }
+
+    uint32_t Count() const; // Records a download would hold
+    uint32_t Dropped() const; // Records lost since Enable
+
+    // Header plus records, oldest first. Returns the bytes written, at most size.
+    size_t Export(uint8_t* out, size_t size);
+    size_t ExportSize() const { return sizeof(TraceHeader) + Count() * sizeof(TraceRecord); }
+
+private:
+    void Append(const TraceRecord& record);
+
+    TraceRecord* records_ = nullptr;        // Allocated on the first Enable
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> exporting_{false};
+    std::atomic<uint32_t> head_{0};         // Records written since Enable
+    std::atomic<uint32_t> skipped_{0};      // Records not written during an export
+};
+
+#endif // MOTION_TRACE_H
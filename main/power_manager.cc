@@ -0,0 +1,69 @@
+#include "power_manager.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "config.h"
+
+#define TAG "PowerManager"
+
+PowerManager& PowerManager::GetInstance() {
+    static PowerManager instance;
+    return instance;
+}
+
+void PowerManager::Init() {
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = PM_MIN_CPU_FREQ_MHZ,
+        .light_sleep_enable = true,
+    };
+    esp_err_t err = esp_pm_configure(&config);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_pm_configure failed: %s", esp_err_to_name(err));
+        return;
+    }
+    for (int id = 0; id < POWER_LOCK_NUM; id++) {
+        esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, PowerLockName(id), &cpu_locks_[id]);
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, PowerLockName(id), &sleep_locks_[id]);
+    }
+    ESP_LOGI(TAG, "CPU %d-%d MHz, automatic light sleep", PM_MIN_CPU_FREQ_MHZ, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#else
+    ESP_LOGW(TAG, "CONFIG_PM_ENABLE is off, CPU fixed at %d MHz", CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#endif
+}
+
+void PowerManager::Acquire(PowerLockId id) {
+#if CONFIG_PM_ENABLE
+    if (sleep_locks_[id] != nullptr) {
+        esp_pm_lock_acquire(sleep_locks_[id]);
+        esp_pm_lock_acquire(cpu_locks_[id]);
+    }
+#endif
+    monitor_.LockAcquired(id, esp_timer_get_time());
+}
+
+void PowerManager::Release(PowerLockId id) {
+    monitor_.LockReleased(id, esp_timer_get_time());
+#if CONFIG_PM_ENABLE
+    if (sleep_locks_[id] != nullptr) {
+        esp_pm_lock_release(cpu_locks_[id]);
+        esp_pm_lock_release(sleep_locks_[id]);
+    }
+#endif
+}
+
+size_t PowerManager::DumpStates(char* buf, size_t len) {
+    if (len == 0) return 0;
+    buf[0] = '\0';
+#if CONFIG_PM_ENABLE
+    FILE* stream = fmemopen(buf, len - 1, "w");
+    if (stream == nullptr) return 0;
+    esp_pm_dump_locks(stream);
+    fclose(stream);
+    buf[len - 1] = '\0'; // fmemopen leaves no terminator when the text fills the buffer
+#endif
+    return strlen(buf);
+}
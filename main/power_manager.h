@@ -0,0 +1,44 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <stddef.h>
+#include "esp_pm.h"
+#include "power_monitor.h"
+
+// Dynamic frequency scaling and automatic light sleep (CONFIG_PM_ENABLE with tickless idle).
+// The chip drops to PM_MIN_CPU_FREQ_MHZ and light-sleeps whenever every task is blocked;
+// clock ticks and web requests hold PM locks so servo frames and replies run at full speed
+// without sleeping in the middle. The PCA9685 boards keep driving the servos while it sleeps.
+class PowerManager {
+public:
+    static PowerManager& GetInstance();
+
+    void Init(); // Once, before the clock and the web server start
+    void Acquire(PowerLockId id);
+    void Release(PowerLockId id);
+    void RecordWake(int64_t latency_us) { monitor_.RecordWake(latency_us); }
+    const PowerMonitor& GetMonitor() const { return monitor_; }
+    // esp_pm_dump_locks() text: lock use and, with CONFIG_PM_PROFILING, time per power mode
+    size_t DumpStates(char* buf, size_t len);
+
+private:
+    PowerManager() = default;
+    PowerManager(const PowerManager&) = delete;
+    PowerManager& operator=(const PowerManager&) = delete;
+
+    PowerMonitor monitor_;
+    esp_pm_lock_handle_t cpu_locks_[POWER_LOCK_NUM] = {};   // ESP_PM_CPU_FREQ_MAX
+    esp_pm_lock_handle_t sleep_locks_[POWER_LOCK_NUM] = {}; // ESP_PM_NO_LIGHT_SLEEP
+};
+
+// Holds a PM lock for the current scope
+class PowerLockGuard {
+public:
+    explicit PowerLockGuard(PowerLockId id) : id_(id) { PowerManager::GetInstance().Acquire(id_); }
+    ~PowerLockGuard() { PowerManager::GetInstance().Release(id_); }
+
+private:
+    PowerLockId id_;
+};
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,50 @@
+#include "power_monitor.h"
+
+#include <algorithm>
+
+void PowerMonitor::LockAcquired(PowerLockId id, int64_t now_us) {
+    acquired_us_[id] = now_us;
+    stats_.lock[id].acquired++;
+    published_lock_[id].Write(stats_.lock[id]);
+}
+
+void PowerMonitor::LockReleased(PowerLockId id, int64_t now_us) {
+    PowerLockStats& lock = stats_.lock[id];
+    uint32_t held_us = (uint32_t)std::max<int64_t>(now_us - acquired_us_[id], 0);
+    lock.held_us += held_us;
+    lock.max_held_us = std::max(lock.max_held_us, held_us);
+    published_lock_[id].Write(lock);
+}
+
+void PowerMonitor::RecordWake(int64_t latency_us) {
+    uint32_t us = (uint32_t)std::max<int64_t>(latency_us, 0);
+    uint32_t ms = us / 1000;
+    int bucket = 0;
+    while (bucket < POWER_WAKE_BUCKETS - 1 && ms >= (1u << bucket)) {
+        bucket++;
+    }
+    PowerWakeStats& wake = stats_.wake;
+    wake.hist[bucket]++;
+    wake.max_us = std::max(wake.max_us, us);
+    wake.total_us += us;
+    wake.count++;
+    if (ms > POWER_WAKE_BUDGET_MS) {
+        wake.late++;
+    }
+    published_wake_.Write(wake);
+}
+
+bool PowerMonitor::Snapshot(PowerStats& stats) const {
+    for (int id = 0; id < POWER_LOCK_NUM; id++) {
+        if (!published_lock_[id].Read(stats.lock[id])) return false;
+    }
+    return published_wake_.Read(stats.wake);
+}
+
+const char* PowerLockName(int id) {
+    switch (id) {
+        case POWER_LOCK_MOTION: return "motion";
+        case POWER_LOCK_HTTP: return "http";
+        default: return "?";
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef POWER_MONITOR_H
+#define POWER_MONITOR_H
+
+#include <stdint.h>
+#include "seqlock.h"
+
+// Accounting for power management: how long each PM lock owner kept the chip out of light
+// sleep, and how long the clock took from a scheduled display change to its first servo
+// write when it had to wake up for it. This file must stay free of ESP-IDF headers so it
+// can also be built on a host.
+
+#define POWER_WAKE_BUDGET_MS 100   // First servo write this long after the change it shows still counts as on time
+#define POWER_WAKE_BUCKETS 12      // Wake latency histogram: bucket 0 < 1 ms, bucket n < 2^n ms, the last is open
+
+// Owners of a PM lock. Each one takes and releases its lock from a single task.
+enum PowerLockId {
+    POWER_LOCK_MOTION, // Clock ticks: mode logic, planning and I2C output
+    POWER_LOCK_HTTP,   // Web request handlers
+    POWER_LOCK_NUM
+};
+
+struct PowerLockStats {
+    uint32_t acquired;
+    uint32_t max_held_us;
+    uint64_t held_us;
+};
+
+struct PowerWakeStats {
+    uint32_t count; // Display changes that woke the clock and moved a servo
+    uint32_t late;  // Of those, first servo write after POWER_WAKE_BUDGET_MS
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t hist[POWER_WAKE_BUCKETS];
+};
+
+struct PowerStats {
+    PowerLockStats lock[POWER_LOCK_NUM];
+    PowerWakeStats wake;
+};
+
+// Lock owners only touch their own lock's counters, the clock task the wake counters. Each
+// of them publishes its part through its own SeqLock, so every part keeps a single writer;
+// any task reads them with Snapshot().
+class PowerMonitor {
+public:
+    void LockAcquired(PowerLockId id, int64_t now_us);
+    void LockReleased(PowerLockId id, int64_t now_us);
+    // Time from the display change a tick was scheduled for to its first servo write
+    void RecordWake(int64_t latency_us);
+
+    // False when every try at one of the parts overlapped a publish
+    bool Snapshot(PowerStats& stats) const;
+
+private:
+    PowerStats stats_ = {};
+    int64_t acquired_us_[POWER_LOCK_NUM] = {};
+    SeqLock<PowerLockStats> published_lock_[POWER_LOCK_NUM];
+    SeqLock<PowerWakeStats> published_wake_;
+};
+
+const char* PowerLockName(int id);
+
+#endif // POWER_MONITOR_H
@@ -0,0 +1,79 @@
+#ifndef SEGMENT_FONT_H
+#define SEGMENT_FONT_H
+
+#include <stdint.h>
+#include <array>
+#include "motion_planner.h"
+
+// Seven-segment font for text, built at compile time from the segment spellings below.
+// Digits keep their glyph ids 0-9; every other character becomes a segment glyph
+// (SegmentGlyph). This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define FONT_CHAR_NUM 128 // ASCII
+
+struct FontEntry {
+    char ch;
+    const char* segments; // Lit segments, 'a' (top) to 'g' (middle)
+};
+
+// Characters a seven-segment digit can show. K, M, V, W and X cannot be drawn and render
+// blank; a letter listed in one case only is used for the other case too.
+inline constexpr FontEntry kFontSpec[] = {
+    {'A', "abcefg"}, {'b', "cdefg"}, {'C', "adef"}, {'c', "deg"}, {'d', "bcdeg"},
+    {'E', "adefg"}, {'F', "aefg"}, {'G', "acdef"}, {'H', "bcefg"}, {'h', "cefg"},
+    {'I', "ef"}, {'i', "e"}, {'J', "bcde"}, {'L', "def"}, {'n', "ceg"},
+    {'O', "abcdef"}, {'o', "cdeg"}, {'P', "abefg"}, {'q', "abcfg"}, {'r', "eg"},
+    {'S', "acdfg"}, {'t', "defg"}, {'U', "bcdef"}, {'u', "cde"}, {'y', "bcdfg"},
+    {'Z', "abdeg"},
+    {'-', "g"}, {'_', "d"}, {'=', "dg"}, {'\'', "b"}, {'"', "bf"},
+    {'[', "adef"}, {']', "abcd"}, {'(', "adef"}, {')', "abcd"}, {'|', "ef"},
+    {'?', "abeg"}, {'*', "abfg"}, {'^', "abf"}, {'/', "beg"},
+};
+
+constexpr uint8_t SegmentMask(const char* segments) {
+    uint8_t mask = 0;
+    for (; *segments != '\0'; segments++) {
+        mask |= 1 << (*segments - 'a');
+    }
+    return mask;
+}
+
+constexpr char OtherCase(char ch) {
+    if (ch >= 'a' && ch <= 'z') return ch - 'a' + 'A';
+    if (ch >= 'A' && ch <= 'Z') return ch - 'A' + 'a';
+    return ch;
+}
+
+// Glyph of every ASCII character, GLYPH_OFF where the font has none
+constexpr std::array<int, FONT_CHAR_NUM> BuildFont() {
+    std::array<int, FONT_CHAR_NUM> font = {};
+    for (int& glyph : font) {
+        glyph = GLYPH_OFF;
+    }
+    for (const FontEntry& entry : kFontSpec) {
+        int glyph = SegmentGlyph(SegmentMask(entry.segments));
+        char other = OtherCase(entry.ch);
+        if (font[(int)other] == GLYPH_OFF) {
+            font[(int)other] = glyph; // Fallback, replaced if the spec lists the other case
+        }
+        font[(int)entry.ch] = glyph;
+    }
+    for (int digit = 0; digit < 10; digit++) {
+        font['0' + digit] = digit;
+    }
+    return font;
+}
+
+inline constexpr std::array<int, FONT_CHAR_NUM> kSegmentFont = BuildFont();
+
+constexpr int CharGlyph(char ch) {
+    return (unsigned char)ch < FONT_CHAR_NUM ? kSegmentFont[(unsigned char)ch] : GLYPH_OFF;
+}
+
+static_assert(CharGlyph('7') == 7, "Digits keep their glyph ids");
+static_assert(CharGlyph('A') == SegmentGlyph(0x77), "A lights every segment but d");
+static_assert(CharGlyph('a') == CharGlyph('A'), "Lower case falls back to upper case");
+static_assert(CharGlyph('c') != CharGlyph('C'), "Both cases listed stay distinct");
+static_assert(CharGlyph('M') == GLYPH_OFF, "Characters outside the font are blank");
+
+#endif // SEGMENT_FONT_H
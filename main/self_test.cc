@@ -0,0 +1,101 @@
+#include "self_test.h"
+
+#include <algorithm>
+
+// Every digit of a 6-digit clock repeats the pattern of digit % 4
+static const int kSelfTestScript[SELFTEST_STEP_NUM][4] = {
+    {8, 8, 8, 8},
+    {1, 2, 3, 4},
+    {5, 6, 7, 8},
+    {9, 0, 1, 2},
+    {3, 4, 5, 6},
+    {7, 8, 9, 0},
+    {1, 1, 1, 1},
+    {8, 8, 8, 8},
+};
+
+const char* SelfTestPhaseName(int phase) {
+    switch (phase) {
+        case SELFTEST_I2C: return "i2c";
+        case SELFTEST_FAST: return "fast";
+        case SELFTEST_SMOOTH: return "smooth";
+        case SELFTEST_FRAMES: return "frames";
+        default: return "?";
+    }
+}
+
+void SelfTestGlyphs(int step, int* glyphs) {
+    for (int digit = 0; digit < CLOCK_DIGIT_NUM; digit++) {
+        glyphs[digit] = kSelfTestScript[step % SELFTEST_STEP_NUM][digit % 4];
+    }
+}
+
+void LatencyStats::Add(int32_t us) {
+    min_us = count ? std::min(min_us, us) : us;
+    max_us = count ? std::max(max_us, us) : us;
+    total_us += us;
+    count++;
+}
+
+int SelfTestPhaseResult::BusyPercent() const {
+    if (wall_us <= 0) return 0;
+    int64_t busy_us = std::max<int64_t>(wall_us - wait_us - i2c.total_us, 0);
+    return (int)(busy_us * 100 / wall_us);
+}
+
+void SelfTest::Start(int64_t now_us) {
+    std::fill(results_, results_ + SELFTEST_PHASE_NUM, SelfTestPhaseResult());
+    phase_ = 0;
+    step_ = 0;
+    phase_start_us_ = now_us;
+    state_ = SELFTEST_RUNNING;
+    Publish();
+}
+
+void SelfTest::Abort() {
+    state_ = SELFTEST_IDLE;
+    Publish();
+}
+
+void SelfTest::NextStep() {
+    step_++;
+    Publish();
+}
+
+void SelfTest::NextPhase(int64_t now_us) {
+    Current().wall_us = now_us - phase_start_us_;
+    phase_start_us_ = now_us;
+    step_ = 0;
+    if (phase_ + 1 < SELFTEST_PHASE_NUM) {
+        phase_++;
+    } else {
+        state_ = SELFTEST_DONE;
+    }
+    Publish();
+}
+
+void SelfTest::Publish() {
+    SelfTestReport report;
+    report.state = state_;
+    report.phase = phase_;
+    report.step = step_;
+    report.total_us = TotalUs();
+    std::copy(results_, results_ + SELFTEST_PHASE_NUM, report.results);
+    published_.Write(report);
+}
+
+void SelfTest::RecordI2C(int32_t us, bool ok) {
+    Current().i2c.Add(us);
+    if (!ok) Current().i2c_failures++;
+}
+
+void SelfTest::RecordTransition(int32_t us, int modelled_ms) {
+    Current().transition.Add(us);
+    Current().modelled_us += (int64_t)modelled_ms * 1000;
+}
+
+int64_t SelfTest::TotalUs() const {
+    int64_t total = 0;
+    for (const SelfTestPhaseResult& result : results_) total += result.wall_us;
+    return total;
+}
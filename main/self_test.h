@@ -0,0 +1,105 @@
+#ifndef SELF_TEST_H
+#define SELF_TEST_H
+
+#include <stdint.h>
+#include "display_topology.h"
+#include "seqlock.h"
+
+// On-device self-benchmark run by MODE_100_TEST: a fixed script of transitions on the real
+// servos, measuring I2C transaction latency, frame time, transition makespan and how busy
+// the clock task is in every phase. Identical on every unit, so reports from production
+// units and from different firmware builds compare directly (GET /selftest).
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define SELFTEST_I2C_ROUNDS 20   // Phase i2c: every channel is rewritten this many times
+#define SELFTEST_STEP_NUM 8      // Transitions per motion phase, one per clock tick
+
+enum SelfTestPhase {
+    SELFTEST_I2C,     // Rewrite every channel at its current position
+    SELFTEST_FAST,    // Scripted transitions, fast steps
+    SELFTEST_SMOOTH,  // Same transitions, smooth steps
+    SELFTEST_FRAMES,  // First animation, frame by frame
+    SELFTEST_PHASE_NUM
+};
+
+const char* SelfTestPhaseName(int phase);
+
+// Glyphs of transition step (< SELFTEST_STEP_NUM) of the motion phases
+void SelfTestGlyphs(int step, int* glyphs);
+
+struct LatencyStats {
+    uint32_t count = 0;
+    int64_t total_us = 0;
+    int32_t min_us = 0;
+    int32_t max_us = 0;
+
+    void Add(int32_t us);
+    int32_t MeanUs() const { return count ? (int32_t)(total_us / count) : 0; }
+};
+
+struct SelfTestPhaseResult {
+    LatencyStats i2c;          // One I2C write transaction
+    LatencyStats frame;        // One WriteFrame (all drivers)
+    LatencyStats transition;   // Planning plus ExecuteTask of one display change
+    int64_t modelled_us = 0;   // EstimatePlanTimeMs of the same transitions, I2C excluded
+    uint32_t i2c_failures = 0;
+    int64_t wall_us = 0;       // Phase duration
+    int64_t wait_us = 0;       // Time the clock task spent in step and frame delays
+
+    // Share of the phase the clock task was running, neither delayed nor waiting for the bus
+    int BusyPercent() const;
+};
+
+enum SelfTestState {
+    SELFTEST_IDLE,
+    SELFTEST_RUNNING,
+    SELFTEST_DONE,
+};
+
+// Progress and results as other tasks see them
+struct SelfTestReport {
+    int state;         // SelfTestState
+    int phase;         // While running
+    int step;
+    int64_t total_us;  // Once done
+    SelfTestPhaseResult results[SELFTEST_PHASE_NUM];
+};
+
+// Used by the clock task only, which publishes a SelfTestReport whenever the test starts,
+// steps or changes phase; other tasks read that with Report().
+class SelfTest {
+public:
+    void Start(int64_t now_us);
+    void Abort();
+    bool Running() const { return state_ == SELFTEST_RUNNING; }
+    bool Done() const { return state_ == SELFTEST_DONE; }
+
+    int Phase() const { return phase_; }
+    int Step() const { return step_; }
+    void NextStep();
+    void NextPhase(int64_t now_us); // Finishes the test after the last phase
+
+    void RecordI2C(int32_t us, bool ok);
+    void RecordFrame(int32_t us) { Current().frame.Add(us); }
+    void RecordTransition(int32_t us, int modelled_ms);
+    void RecordWait(int32_t us) { Current().wait_us += us; }
+
+    const SelfTestPhaseResult& Result(int phase) const { return results_[phase]; }
+    int64_t TotalUs() const;
+
+    // Any task: the last published report, false when every try overlapped a publish
+    bool Report(SelfTestReport& report) const { return published_.Read(report); }
+
+private:
+    SelfTestPhaseResult& Current() { return results_[phase_]; }
+    void Publish();
+
+    int state_ = SELFTEST_IDLE;
+    int phase_ = 0;
+    int step_ = 0;
+    int64_t phase_start_us_ = 0;
+    SelfTestPhaseResult results_[SELFTEST_PHASE_NUM];
+    SeqLock<SelfTestReport> published_;
+};
+
+#endif // SELF_TEST_H
@@ -0,0 +1,48 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Lock-free hand-over of state and statistics from the clock task to readers on other
+// tasks, such as the web server.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define SEQLOCK_READ_RETRIES 8 // A reader gives up after this many torn copies
+
+// Versioned snapshot for one writer and any number of readers. The writer never waits:
+// it makes the sequence odd, copies the value and makes it even again. A reader copies
+// the value and keeps the copy only if the sequence was even and unchanged around it.
+template <typename T>
+class SeqLock {
+public:
+    void Write(const T& value) {
+        uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&value_, &value, sizeof(T));
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // False if every attempt overlapped a write
+    bool Read(T& value) const {
+        for (int attempt = 0; attempt < SEQLOCK_READ_RETRIES; attempt++) {
+            uint32_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            memcpy(&value, &value_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) return true;
+        }
+        return false;
+    }
+
+    // Writes so far
+    uint32_t Version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    std::atomic<uint32_t> sequence_{0};
+    T value_ = {};
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,84 @@
+#include "servo_telemetry.h"
+
+#include <stdlib.h>
+#include <algorithm>
+
+ServoTelemetry::ServoTelemetry() {
+    std::fill(last_position_, last_position_ + SERVO_CHANNEL_NUM, -1);
+}
+
+void ServoTelemetry::RecordWrite(int channel, int position, int ms) {
+    if (channel < 0 || channel >= SERVO_CHANNEL_NUM) return;
+    int last = last_position_[channel];
+    last_position_[channel] = position;
+    if (last == -1 || last == position) return; // Position unknown before the first write, or no change
+
+    stats_[channel].travel += abs(position - last);
+    stats_[channel].load_ms += ms;
+    dirty_ = true;
+    changed_ = true;
+}
+
+void ServoTelemetry::RecordMove(int channel) {
+    if (channel < 0 || channel >= SERVO_CHANNEL_NUM) return;
+    stats_[channel].moves++;
+    dirty_ = true;
+    changed_ = true;
+}
+
+void ServoTelemetry::RecordI2CFailure(int channel) {
+    if (channel < 0 || channel >= SERVO_CHANNEL_NUM) return;
+    stats_[channel].i2c_failures++;
+    dirty_ = true;
+    changed_ = true;
+}
+
+bool ServoTelemetry::Load(const ServoTelemetryBlob& blob) {
+    if (blob.version != TELEMETRY_BLOB_VERSION || blob.channel_num != SERVO_CHANNEL_NUM) return false;
+    std::copy(blob.channels, blob.channels + SERVO_CHANNEL_NUM, stats_);
+    dirty_ = false;
+    changed_ = true;
+    return true;
+}
+
+void ServoTelemetry::Snapshot(ServoTelemetryBlob& blob) const {
+    blob.version = TELEMETRY_BLOB_VERSION;
+    blob.channel_num = SERVO_CHANNEL_NUM;
+    std::copy(stats_, stats_ + SERVO_CHANNEL_NUM, blob.channels);
+}
+
+void ServoTelemetry::Publish() {
+    if (!changed_) return;
+    ServoTelemetryBlob blob;
+    Snapshot(blob);
+    published_.Write(blob);
+    changed_ = false;
+}
+
+int ServoTelemetry::FindSlowChannels(const ServoTelemetryBlob& blob, int* channels, int max) {
+    const ServoChannelStats* stats = blob.channels;
+    // Load time per move of every channel that has moved
+    uint32_t per_move[SERVO_CHANNEL_NUM];
+    int moved = 0;
+    for (int ch = 0; ch < SERVO_CHANNEL_NUM; ch++) {
+        if (stats[ch].moves > 0) {
+            per_move[moved++] = stats[ch].load_ms / stats[ch].moves;
+        }
+    }
+    if (moved == 0) return 0;
+    std::nth_element(per_move, per_move + moved / 2, per_move + moved);
+    const uint64_t limit = (uint64_t)per_move[moved / 2] * TELEMETRY_SLOW_PERCENT;
+
+    auto PerMove = [&](int ch) { return stats[ch].load_ms / stats[ch].moves; };
+    int slow[SERVO_CHANNEL_NUM];
+    int found = 0;
+    for (int ch = 0; ch < SERVO_CHANNEL_NUM; ch++) {
+        if (stats[ch].moves > 0 && (uint64_t)PerMove(ch) * 100 > limit) {
+            slow[found++] = ch;
+        }
+    }
+    std::sort(slow, slow + found, [&](int a, int b) { return PerMove(a) > PerMove(b); });
+    found = std::min(found, max);
+    std::copy(slow, slow + found, channels);
+    return found;
+}
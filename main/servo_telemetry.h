@@ -0,0 +1,66 @@
+#ifndef SERVO_TELEMETRY_H
+#define SERVO_TELEMETRY_H
+
+#include <stdint.h>
+#include "display_topology.h"
+#include "seqlock.h"
+
+// Per-servo wear counters (odometer, moves, time under load, I2C failures), kept in RAM
+// and persisted by the clock as one NVS blob at most every TELEMETRY_SAVE_INTERVAL_MIN.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define TELEMETRY_SAVE_INTERVAL_MIN 30 // 最多每 30 分钟写一次 flash
+#define TELEMETRY_BLOB_VERSION 1
+#define TELEMETRY_SLOW_PERCENT 150     // A channel is slow above 150% of the median load time per move
+
+struct ServoChannelStats {
+    uint32_t travel;       // Counts moved in total
+    uint32_t moves;        // Planned moves
+    uint32_t load_ms;      // Time the servo was driven towards a new position
+    uint32_t i2c_failures; // PWM writes that failed after all retries
+};
+
+// Layout stored in NVS, dropped when the version or channel count does not match
+struct ServoTelemetryBlob {
+    uint16_t version;
+    uint16_t channel_num;
+    ServoChannelStats channels[SERVO_CHANNEL_NUM];
+};
+
+// Counters are only updated from the clock task, which publishes them once per tick;
+// readers on other tasks take the published copy with Read().
+class ServoTelemetry {
+public:
+    ServoTelemetry();
+
+    // A PWM write moved channel to position and held it for ms
+    void RecordWrite(int channel, int position, int ms);
+    void RecordMove(int channel);
+    void RecordI2CFailure(int channel);
+
+    // Restore counters saved by an earlier boot, false if blob does not fit this build
+    bool Load(const ServoTelemetryBlob& blob);
+    void Snapshot(ServoTelemetryBlob& blob) const; // Clock task
+
+    // Clock task: make the counters visible to Read() if they changed since the last call
+    void Publish();
+    // Any task: the published counters, false when every try overlapped a Publish()
+    bool Read(ServoTelemetryBlob& blob) const { return published_.Read(blob); }
+
+    // Something changed since the last MarkSaved()
+    bool Dirty() const { return dirty_; }
+    void MarkSaved() { dirty_ = false; }
+
+    // Channels of blob whose load time per move exceeds TELEMETRY_SLOW_PERCENT of the
+    // median, worst first. Returns how many were written to channels (at most max).
+    static int FindSlowChannels(const ServoTelemetryBlob& blob, int* channels, int max);
+
+private:
+    ServoChannelStats stats_[SERVO_CHANNEL_NUM] = {};
+    int last_position_[SERVO_CHANNEL_NUM];  // -1 until the first write after boot
+    bool dirty_ = false;
+    bool changed_ = true; // Not published yet
+    SeqLock<ServoTelemetryBlob> published_;
+};
+
+#endif // SERVO_TELEMETRY_H
@@ -16,6 +16,8 @@ public:
     void SetString(const std::string& key, const std::string& value);
     int32_t GetInt(const std::string& key, int32_t default_value = 0);
     void SetInt(const std::string& key, int32_t value);
+    bool GetBlob(const std::string& key, void* data, size_t size); // false unless exactly size bytes are stored
+    void SetBlob(const std::string& key, const void* data, size_t size);
     void EraseKey(const std::string& key);
     void EraseAll();
 
@@ -0,0 +1,54 @@
+#include "speed_profile.h"
+
+#include <string.h>
+#include <algorithm>
+
+const SpeedProfile kSpeedProfiles[SPEED_PROFILE_NUM] = {
+    {"silent", SERVO_STEP_SMOOTH},
+    {"normal", SERVO_STEP_NORMAL},
+    {"fast", SERVO_STEP_FAST},
+    {"instant", SERVO_STEP_INSTANT},
+};
+
+int FindSpeedProfile(const char* name) {
+    for (int i = 0; i < SPEED_PROFILE_NUM; i++) {
+        if (strcmp(kSpeedProfiles[i].name, name) == 0) return i;
+    }
+    return SPEED_NONE;
+}
+
+const char* SpeedModeName(int speed_mode) {
+    switch (speed_mode) {
+        case SPEED_MODE_CLOCK: return "clock";
+        case SPEED_MODE_NUMBER: return "number";
+        case SPEED_MODE_COUNTDOWN: return "countdown";
+        case SPEED_MODE_TIMER: return "timer";
+        case SPEED_MODE_TEXT: return "text";
+        case SPEED_MODE_IDLE: return "idle";
+        default: return "?";
+    }
+}
+
+int FindSpeedMode(const char* name) {
+    for (int i = 0; i < SPEED_MODE_NUM; i++) {
+        if (strcmp(SpeedModeName(i), name) == 0) return i;
+    }
+    return -1;
+}
+
+void SpeedMonitor::Record(int profile, int64_t elapsed_us, int modelled_ms) {
+    SpeedTransitionStats& stats = stats_.profile[profile];
+    uint32_t us = (uint32_t)std::max<int64_t>(elapsed_us, 0);
+    stats.transitions++;
+    stats.max_us = std::max(stats.max_us, us);
+    stats.total_us += us;
+    stats.modelled_ms += modelled_ms;
+    published_.Write(stats_);
+}
+
+bool SpeedMonitor::Snapshot(SpeedTransitionStats* stats) const {
+    ProfileStats copy;
+    if (!published_.Read(copy)) return false;
+    std::copy(copy.profile, copy.profile + SPEED_PROFILE_NUM, stats);
+    return true;
+}
@@ -0,0 +1,73 @@
+#ifndef SPEED_PROFILE_H
+#define SPEED_PROFILE_H
+
+#include <stdint.h>
+#include "motion_engine.h"
+#include "seqlock.h"
+
+// Named servo speed profiles, chosen per display mode and optionally overridden inside the
+// nightly window, plus the transition times measured with each of them so the noise and
+// latency trade-off can be judged from real moves (GET /speed).
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define SPEED_NONE -1 // No night override
+
+enum SpeedProfileId {
+    SPEED_SILENT,  // Small steps, the former mute mode
+    SPEED_NORMAL,
+    SPEED_FAST,    // The former default
+    SPEED_INSTANT, // Every move in one write, loudest
+    SPEED_PROFILE_NUM
+};
+
+struct SpeedProfile {
+    const char* name;
+    int step; // Position change per write, one write every SERVO_STEP_DELAY_MS
+};
+
+extern const SpeedProfile kSpeedProfiles[SPEED_PROFILE_NUM];
+
+// SpeedProfileId by name, SPEED_NONE if unknown
+int FindSpeedProfile(const char* name);
+
+// Display modes that pick their own profile
+enum SpeedMode {
+    SPEED_MODE_CLOCK,
+    SPEED_MODE_NUMBER,    // Numbers and the calibration preview
+    SPEED_MODE_COUNTDOWN,
+    SPEED_MODE_TIMER,     // Stopwatch
+    SPEED_MODE_TEXT,
+    SPEED_MODE_IDLE,      // Idle and shutdown
+    SPEED_MODE_NUM
+};
+
+// Name used in the web API and, prefixed with "speed_", as the settings key
+const char* SpeedModeName(int speed_mode);
+// SpeedMode by name, -1 if unknown
+int FindSpeedMode(const char* name);
+
+struct SpeedTransitionStats {
+    uint32_t transitions;
+    uint32_t max_us;
+    uint64_t total_us;    // Planning and moves, measured
+    uint64_t modelled_ms; // EstimatePlanTimeMs() of the same transitions
+};
+
+// Record() runs in the clock task, which publishes the stats after every transition;
+// any task reads them with Snapshot().
+class SpeedMonitor {
+public:
+    void Record(int profile, int64_t elapsed_us, int modelled_ms);
+    // stats[SPEED_PROFILE_NUM], false when every try overlapped a publish
+    bool Snapshot(SpeedTransitionStats* stats) const;
+
+private:
+    struct ProfileStats {
+        SpeedTransitionStats profile[SPEED_PROFILE_NUM];
+    };
+
+    ProfileStats stats_ = {};
+    SeqLock<ProfileStats> published_;
+};
+
+#endif // SPEED_PROFILE_H
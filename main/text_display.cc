@@ -0,0 +1,46 @@
+#include "text_display.h"
+
+#include <string.h>
+#include "segment_font.h"
+
+int TextDisplay::SetText(const char* text, int64_t now_us) {
+    int len = strnlen(text, TEXT_MAX_LEN);
+    memcpy(text_, text, len);
+    text_[len] = '\0';
+    start_us_ = now_us;
+
+    // Text that fits stands still, left-aligned
+    if (len <= CLOCK_DIGIT_NUM) {
+        for (int digit = 0; digit < CLOCK_DIGIT_NUM; digit++) {
+            frames_[0][digit] = digit < len ? CharGlyph(text_[digit]) : GLYPH_OFF;
+        }
+        frame_num_ = 1;
+        return len;
+    }
+
+    // Frame n starts at position n of the circular sequence text + gap
+    int cycle = len + TEXT_SCROLL_GAP;
+    for (int frame = 0; frame < cycle; frame++) {
+        for (int digit = 0; digit < CLOCK_DIGIT_NUM; digit++) {
+            int pos = (frame + digit) % cycle;
+            frames_[frame][digit] = pos < len ? CharGlyph(text_[pos]) : GLYPH_OFF;
+        }
+    }
+    frame_num_ = cycle;
+    return len;
+}
+
+int TextDisplay::Step(int64_t now_us) const {
+    int64_t elapsed_us = now_us > start_us_ ? now_us - start_us_ : 0;
+    return (int)(elapsed_us / (TEXT_SCROLL_STEP_MS * 1000LL));
+}
+
+const int* TextDisplay::Glyphs(int64_t now_us) const {
+    return frames_[frame_num_ > 1 ? Step(now_us) % frame_num_ : 0];
+}
+
+int64_t TextDisplay::NextChangeUs(int64_t now_us) const {
+    if (!Scrolling()) return -1;
+    int64_t next_us = start_us_ + (int64_t)(Step(now_us) + 1) * TEXT_SCROLL_STEP_MS * 1000LL;
+    return next_us - now_us;
+}
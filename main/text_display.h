@@ -0,0 +1,39 @@
+#ifndef TEXT_DISPLAY_H
+#define TEXT_DISPLAY_H
+
+#include <stdint.h>
+#include "display_topology.h"
+
+// Text on the digits (MODE_05_TEXT). Text that fits is shown once; longer text scrolls
+// one position per step, followed by TEXT_SCROLL_GAP blanks before it starts over. Every
+// frame of the sequence is laid out when the text is set, so a step is only a lookup,
+// and the step comes from the start timestamp like ClockTimer.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define TEXT_MAX_LEN 32            // Longer text is cut
+#define TEXT_SCROLL_GAP 1          // Blank positions between the end of the text and its start
+#define TEXT_SCROLL_STEP_MS 1000   // Time per scroll position, long enough for a smooth transition
+#define TEXT_FRAME_MAX (TEXT_MAX_LEN + TEXT_SCROLL_GAP)
+
+class TextDisplay {
+public:
+    // Lay out text (cut at TEXT_MAX_LEN) from now_us on, returns the characters kept
+    int SetText(const char* text, int64_t now_us);
+
+    const char* Text() const { return text_; }
+    bool Scrolling() const { return frame_num_ > 1; }
+    // Glyphs[CLOCK_DIGIT_NUM] shown at now_us
+    const int* Glyphs(int64_t now_us) const;
+    // Microseconds from now_us until the next scroll step, -1 if the text does not scroll
+    int64_t NextChangeUs(int64_t now_us) const;
+
+private:
+    int Step(int64_t now_us) const;
+
+    char text_[TEXT_MAX_LEN + 1] = {};
+    int frames_[TEXT_FRAME_MAX][CLOCK_DIGIT_NUM] = {};
+    int frame_num_ = 0;
+    int64_t start_us_ = 0;
+};
+
+#endif // TEXT_DISPLAY_H
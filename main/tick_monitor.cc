@@ -0,0 +1,80 @@
+#include "tick_monitor.h"
+
+#include <algorithm>
+
+void TickMonitor::Wakeup(int64_t now_us, bool command) {
+    const int64_t window_us = (int64_t)TICK_WAKEUP_WINDOW_S * 1000000;
+    if (stats_.wakeups == 0) {
+        stats_.first_wakeup_us = now_us;
+        window_start_us_ = now_us;
+    }
+    int64_t windows = (now_us - window_start_us_) / window_us;
+    if (windows > 0) {
+        stats_.wakeups_last_hour = windows == 1 ? stats_.wakeups_this_hour : 0;
+        stats_.wakeups_this_hour = 0;
+        window_start_us_ += windows * window_us;
+    }
+    stats_.wakeups++;
+    stats_.wakeups_this_hour++;
+    if (command) {
+        stats_.command_wakeups++;
+        due_us_ = 0;
+    }
+    published_.Write(stats_);
+}
+
+int TickMonitor::BeginTick(int64_t now_us) {
+    const int64_t period_us = (int64_t)TICK_PERIOD_MS * 1000;
+    int elapsed = 1;
+    int64_t late_us = 0;
+    if (due_us_ != 0) {
+        if (now_us < due_us_ - (int64_t)TICK_EARLY_SLACK_MS * 1000) {
+            stats_.merged++;
+            published_.Write(stats_);
+            return 0;
+        }
+        late_us = std::max<int64_t>(now_us - due_us_, 0);
+        elapsed += late_us / period_us;
+        stats_.missed += elapsed - 1;
+    } else {
+        due_us_ = now_us; // The first tick defines the schedule
+    }
+    due_us_ += elapsed * period_us;
+
+    uint32_t late_ms = late_us / 1000;
+    int bucket = 0;
+    while (bucket < TICK_HIST_BUCKETS - 1 && late_ms >= (1u << bucket)) {
+        bucket++;
+    }
+    stats_.late_hist[bucket]++;
+    stats_.max_late_ms = std::max(stats_.max_late_ms, late_ms);
+    stats_.ticks++;
+    begin_us_ = now_us;
+    published_.Write(stats_);
+    return elapsed;
+}
+
+void FrameJitter::Record(int64_t late_us) {
+    if (reset_.exchange(false, std::memory_order_relaxed)) {
+        stats_ = {};
+    }
+    uint32_t us = (uint32_t)std::max<int64_t>(late_us, 0);
+    int bucket = 0;
+    while (bucket < JITTER_HIST_BUCKETS - 1 && us >= (100u << bucket)) {
+        bucket++;
+    }
+    stats_.hist[bucket]++;
+    stats_.max_us = std::max(stats_.max_us, us);
+    stats_.total_us += us;
+    stats_.frames++;
+    published_.Write(stats_);
+}
+
+bool TickMonitor::EndTick(int64_t now_us) {
+    uint32_t run_ms = (now_us - begin_us_) / 1000;
+    stats_.max_run_ms = std::max(stats_.max_run_ms, run_ms);
+    bool overran = run_ms > TICK_PERIOD_MS;
+    if (overran) stats_.overruns++;
+    published_.Write(stats_);
+    return overran;
+}
@@ -0,0 +1,92 @@
+#ifndef TICK_MONITOR_H
+#define TICK_MONITOR_H
+
+#include <stdint.h>
+#include <atomic>
+#include "seqlock.h"
+
+// Watches the clock timer. A long transition blocks the timer task inside OnTimerTick;
+// FreeRTOS then delivers the expiries it missed back to back when the tick returns. The
+// monitor compares every callback with the time it was due, lets the first late one run
+// with the number of periods that really elapsed and tells the caller to drop the replayed
+// ones, so modes jump straight to the current state instead of replaying stale seconds.
+// This file must stay free of ESP-IDF headers so it can also be built on a host.
+
+#define TICK_PERIOD_MS 1000
+#define TICK_EARLY_SLACK_MS 100 // A callback this much before its due time is a replayed expiry
+#define TICK_HIST_BUCKETS 16    // Lateness histogram: bucket 0 < 1 ms, bucket n < 2^n ms, the last is open
+#define TICK_WAKEUP_WINDOW_S 3600 // Wakeups are also counted per hour of uptime
+#define JITTER_HIST_BUCKETS 12    // Frame start jitter: bucket 0 < 100 us, bucket n < 100 * 2^n us, the last is open
+
+struct TickStats {
+    uint32_t ticks;         // Ticks that ran
+    uint32_t missed;        // Periods covered by a late tick instead of a tick of their own
+    uint32_t merged;        // Replayed expiries dropped
+    uint32_t overruns;      // Ticks that ran longer than a period
+    uint32_t plan_retries;  // Display frames put back to be planned again by a later tick
+    uint32_t max_late_ms;   // Worst lateness against the due time
+    uint32_t max_run_ms;    // Longest tick
+    uint32_t late_hist[TICK_HIST_BUCKETS];
+    uint32_t wakeups;           // Timer callbacks of any kind, replayed and command wakes included
+    uint32_t command_wakeups;   // Callbacks a command brought forward
+    uint32_t wakeups_this_hour; // In the running TICK_WAKEUP_WINDOW_S window
+    uint32_t wakeups_last_hour; // In the last complete window
+    int64_t first_wakeup_us;
+};
+
+// Only used from the timer task, which publishes the counters after every call; readers
+// on other tasks take a copy with Snapshot().
+class TickMonitor {
+public:
+    // Every timer callback, before anything else. A command wake was not due at any time and
+    // is not checked for lateness.
+    void Wakeup(int64_t now_us, bool command);
+    // Start of a timer callback that may run the tick. Returns the periods elapsed since the last tick that ran:
+    // 1 on time, more after missed ticks, 0 for a replayed expiry that must not run.
+    int BeginTick(int64_t now_us);
+    // End of the tick that BeginTick let run, true when it overran its period
+    bool EndTick(int64_t now_us);
+    // During a tick: its frame could not be queued, a later tick plans it again. Published by EndTick.
+    void PlanRetry() { stats_.plan_retries++; }
+
+    // The timer was re-armed at now_us to fire after delay_ms, at the next display change
+    void Reschedule(int64_t now_us, int delay_ms) { due_us_ = now_us + (int64_t)delay_ms * 1000; }
+    // The next tick is not due at a set time: the timer was stopped, or a command woke it early
+    void Unschedule() { due_us_ = 0; }
+
+    // False when every try overlapped a publish, retry later
+    bool Snapshot(TickStats& stats) const { return published_.Read(stats); }
+
+private:
+    TickStats stats_ = {}; // Timer task only
+    SeqLock<TickStats> published_;
+    int64_t due_us_ = 0;   // Due time of the next tick, 0 if none
+    int64_t begin_us_ = 0; // Start of the running tick
+    int64_t window_start_us_ = 0;
+};
+
+struct JitterStats {
+    uint32_t frames;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t hist[JITTER_HIST_BUCKETS];
+};
+
+// How late animation frames start against their schedule (start + n * ANIM_FRAME_MS), to
+// check that network and web load on the other core does not delay servo output.
+// Recorded and published by the clock task; any task may ask for a reset to measure a
+// fresh window, it takes effect with the next frame.
+class FrameJitter {
+public:
+    void Record(int64_t late_us);
+    void RequestReset() { reset_.store(true, std::memory_order_relaxed); }
+    // False when every try overlapped a publish, retry later
+    bool Snapshot(JitterStats& stats) const { return published_.Read(stats); }
+
+private:
+    JitterStats stats_ = {}; // Clock task only
+    SeqLock<JitterStats> published_;
+    std::atomic<bool> reset_{false};
+};
+
+#endif // TICK_MONITOR_H
@@ -3,6 +3,9 @@
 #include "esp_ota_ops.h"
 #include <string.h>
 #include <stdlib.h> // 用于 malloc 和 free
+#include <ctype.h>
+#include <algorithm>
+#include <atomic>
 #include "html/adjust.h"
 #include "html/index.h"
 #include "html/update.h"
@@ -16,10 +19,14 @@
 #include <sys/time.h>
 #include <time.h>
 #include "esp_random.h"
+#include "esp_timer.h"
 #include "esp_system.h"
 #include "config.h"
 #include "main.h"
 #include "CyberClock.h"
+#include "motion_bench.h"
+#include "motion_kernel.h"
+#include "power_manager.h"
 // Captive Portal 探测路径处理
 #include "esp_http_server.h"
 
@@ -35,6 +42,14 @@ extern SemaphoreHandle_t server_time_ready_semaphore;
 
 
 static esp_err_t handle_get_calibration(httpd_req_t *req) {
+    // 时钟任务发布的偏移量，读到一半被改写时返回 503
+    ClockState state;
+    if (!CyberClock::GetInstance().GetState(state)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "State busy, retry");
+        return ESP_OK;
+    }
+
     // 创建 JSON 文档
     cJSON *root = cJSON_CreateObject();
     if (!root) {
@@ -43,9 +58,7 @@ static esp_err_t handle_get_calibration(httpd_req_t *req) {
         return ESP_FAIL;
     }
 
-    // 通过CyberClock实例获取servo_offsets_
-    int* servo_offsets = CyberClock::GetInstance().GetServoOffsets();
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < CLOCK_DIGIT_NUM; i++) {
         cJSON *digit_array = cJSON_CreateArray();
         if (!digit_array) {
             ESP_LOGE(TAG, "Failed to create JSON array");
@@ -53,10 +66,10 @@ static esp_err_t handle_get_calibration(httpd_req_t *req) {
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create JSON array");
             return ESP_FAIL;
         }
-        for (int j = 0; j < 7; j++) {
-            cJSON_AddItemToArray(digit_array, cJSON_CreateNumber(servo_offsets[i * 7 + j]));
+        for (int j = 0; j < SEGMENTS_PER_DIGIT; j++) {
+            cJSON_AddItemToArray(digit_array, cJSON_CreateNumber(state.offset[i * SEGMENTS_PER_DIGIT + j]));
         }
-        char digit_key[8];
+        char digit_key[12];
         snprintf(digit_key, sizeof(digit_key), "digit%d", i + 1);
         cJSON_AddItemToObject(root, digit_key, digit_array);
     }
@@ -203,7 +216,7 @@ static esp_err_t handle_adjust_page(httpd_req_t *req) {
     httpd_resp_set_type(req, "text/html");
     httpd_resp_send(req, adjust_html, strlen(adjust_html));
 
-    CyberClock::GetInstance().SetNumber(8, 8, 8, 8); // 设置数字为 8888，显示校准效果
+    CyberClock::GetInstance().PreviewDisplay(MODE_98_ADJUST); // 显示 8888 方便校准，不覆盖倒计时等正在使用的显示
     return ESP_OK;
 }
 
@@ -211,7 +224,7 @@ static esp_err_t handle_timer_page(httpd_req_t *req) {
     httpd_resp_set_type(req, "text/html");
     httpd_resp_send(req, timer_html, strlen(timer_html));
 
-    CyberClock::GetInstance().SetTimer(0); 
+    CyberClock::GetInstance().PreviewDisplay(MODE_04_SET_TIMER); // 预览秒表，不打断正在运行的计时
     return ESP_OK;
 }
 
@@ -233,21 +246,25 @@ static esp_err_t handle_adjust(httpd_req_t *req) {
         return ESP_FAIL;
     }
 
-    // 更新 servo_offsets_
-    int* servo_offsets = CyberClock::GetInstance().GetServoOffsets();
-    cJSON *digits[4] = {
-        cJSON_GetObjectItem(root, "digit1"),
-        cJSON_GetObjectItem(root, "digit2"),
-        cJSON_GetObjectItem(root, "digit3"),
-        cJSON_GetObjectItem(root, "digit4")
-    };
-
+    // 从当前偏移量开始，数据里没有的舵机保持不变
+    ClockState state;
+    if (!CyberClock::GetInstance().GetState(state)) {
+        cJSON_Delete(root);
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "State busy, retry");
+        return ESP_OK;
+    }
+    int servo_offsets[SERVO_CHANNEL_NUM];
+    std::copy(state.offset, state.offset + SERVO_CHANNEL_NUM, servo_offsets);
     int index = 0;
-    for (int i = 0; i < 4; i++) {
-        if (cJSON_IsArray(digits[i])) {
+    for (int i = 0; i < CLOCK_DIGIT_NUM; i++) {
+        char digit_key[12];
+        snprintf(digit_key, sizeof(digit_key), "digit%d", i + 1);
+        cJSON *digit = cJSON_GetObjectItem(root, digit_key);
+        if (cJSON_IsArray(digit)) {
             cJSON *segment = nullptr;
-            cJSON_ArrayForEach(segment, digits[i]) {
-                if (index < 28 && cJSON_IsNumber(segment)) {
+            cJSON_ArrayForEach(segment, digit) {
+                if (index < SERVO_CHANNEL_NUM && cJSON_IsNumber(segment)) {
                     servo_offsets[index++] = segment->valueint;
                 }
             }
@@ -256,21 +273,14 @@ static esp_err_t handle_adjust(httpd_req_t *req) {
 
     cJSON_Delete(root);
 
-    // 保存调整数据到设置
-    char adjust_data[512] = {0}; // 假设 28 个整数不会超过 512 字节
-    int offset = 0;
-    for (int i = 0; i < 28; i++) {
-        offset += snprintf(adjust_data + offset, sizeof(adjust_data) - offset, "%d|", servo_offsets[i]);
-    }
-
-    // 移除最后一个多余的分隔符
-    if (offset > 0) {
-        adjust_data[offset - 1] = '\0';
+    // 时钟任务应用偏移量并保存到设置
+    if (!CyberClock::GetInstance().SetServoOffsets(servo_offsets)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "Command queue full, retry");
+        return ESP_OK;
     }
-
-    Settings settings("cyberclock",true);
-    settings.SetString("adjust_data", adjust_data);
-    ESP_LOGI(TAG, "Saved adjust_data: %s", adjust_data);
+    // 每次校准都续租 8888 预览，调整超过 DISPLAY_PAGE_LEASE_S 也不会被时间替换
+    CyberClock::GetInstance().PreviewDisplay(MODE_98_ADJUST);
 
     // 返回响应
     httpd_resp_set_type(req, "application/json");
@@ -280,8 +290,25 @@ static esp_err_t handle_adjust(httpd_req_t *req) {
 
 
 
+// 查询参数原地 URL 解码：%XX 和 '+'（空格）
+static void url_decode(char* str) {
+    char* out = str;
+    for (char* in = str; *in != '\0'; in++) {
+        if (*in == '+') {
+            *out++ = ' ';
+        } else if (*in == '%' && isxdigit((unsigned char)in[1]) && isxdigit((unsigned char)in[2])) {
+            char hex[3] = {in[1], in[2], '\0'};
+            *out++ = (char)strtol(hex, nullptr, 16);
+            in += 2;
+        } else {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+}
+
 static esp_err_t handle_set(httpd_req_t *req) {
-    char query[128] = {0};
+    char query[256] = {0}; // text 参数编码后最长约 3 * TEXT_MAX_LEN
     if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
         ESP_LOGI(TAG, "Query: %s", query);
         char digit[16] = {0};
@@ -318,6 +345,17 @@ static esp_err_t handle_set(httpd_req_t *req) {
                 CyberClock::GetInstance().ShowTime(); // 显示时间
             } 
         }
+        // 任意时长的倒计时 /set?countdown=秒数，超过 99:59 自动显示为 HH:MM
+        char countdown[12] = {0};
+        if (httpd_query_key_value(query, "countdown", countdown, sizeof(countdown)) == ESP_OK) {
+            CyberClock::GetInstance().SetCountDown(atoi(countdown));
+        }
+        // 显示文字 /set?text=HELLO，放不下时滚动，超过 TEXT_MAX_LEN 个字符截断
+        char text[3 * TEXT_MAX_LEN + 1] = {0};
+        if (httpd_query_key_value(query, "text", text, sizeof(text)) == ESP_OK) {
+            url_decode(text);
+            CyberClock::GetInstance().SetText(text);
+        }
         if (httpd_query_key_value(query, "tz", tz, sizeof(tz)) == ESP_OK) {
             // 处理时区参数
             SetTimezoneOffset(atoi(tz)); // 设置时区偏移
@@ -360,6 +398,16 @@ static esp_err_t handle_set(httpd_req_t *req) {
             CyberClock::GetInstance().SetServoSilentMode(silent);
             ESP_LOGI(TAG, "Set servosilent: %d", silent);
         }
+        // 每个模式的速度 /set?speed_clock=silent&speed_countdown=fast，夜间覆盖 /set?speed_night=silent（none 关闭）
+        char speed_key[24];
+        char speed_str[16];
+        for (int speed_mode = 0; speed_mode <= SPEED_MODE_NUM; speed_mode++) {
+            const char* name = speed_mode < SPEED_MODE_NUM ? SpeedModeName(speed_mode) : "night";
+            snprintf(speed_key, sizeof(speed_key), "speed_%s", name);
+            if (httpd_query_key_value(query, speed_key, speed_str, sizeof(speed_str)) == ESP_OK) {
+                CyberClock::GetInstance().SetSpeed(name, speed_str);
+            }
+        }
         //设置12小时制，var url = h1224.checked ? "/set?h=12" : "/set?h=24";
         if (httpd_query_key_value(query, "h", digit, sizeof(digit)) == ESP_OK) {
             int h = atoi(digit);
@@ -422,6 +470,14 @@ static esp_err_t handle_set(httpd_req_t *req) {
                 ESP_LOGI(TAG, "Deleted MAC address, set to default");
             }
         }
+        // 播放动画 /set?anim=wave，设置整点动画 /set?hourly=wave（none 表示关闭）
+        char anim_str[16];
+        if (httpd_query_key_value(query, "anim", anim_str, sizeof(anim_str)) == ESP_OK) {
+            CyberClock::GetInstance().PlayAnimation(anim_str);
+        }
+        if (httpd_query_key_value(query, "hourly", anim_str, sizeof(anim_str)) == ESP_OK) {
+            CyberClock::GetInstance().SetHourlyAnimation(anim_str);
+        }
         // StartTimer，如果接受到参数Timer=start，则启动定时器
         char timer_str[16];
         if (httpd_query_key_value(query, "timer", timer_str, sizeof(timer_str)) == ESP_OK) {
@@ -440,6 +496,103 @@ static esp_err_t handle_set(httpd_req_t *req) {
 }
 
 
+// 运动基准测试：模拟一整天的数字切换，返回 JSON 结果（不驱动舵机）
+// /bench 的测试在单独的任务里运行，网页服务器照常处理其他请求；同一时间只运行一个
+// （它们共用 MOTION_POOL_BENCH），运行中再次请求返回 503
+enum BenchKind { BENCH_MOTION, BENCH_KERNEL, BENCH_CORPUS_CHECK, BENCH_CORPUS_GENERATE };
+
+struct BenchJob {
+    httpd_req_t *req; // httpd_req_async_handler_begin 复制的请求，由测试任务回复
+    BenchKind kind;
+    MotionBenchConfig config;
+};
+
+static std::atomic<bool> bench_busy{false};
+
+static void bench_task(void *arg) {
+    BenchJob *job = static_cast<BenchJob *>(arg);
+    {
+        PowerLockGuard power_lock(POWER_LOCK_HTTP); // 和网页请求一样全速运行，内核计时不受降频影响
+        std::string json;
+        int64_t start_us = esp_timer_get_time();
+        switch (job->kind) {
+            case BENCH_CORPUS_GENERATE:
+                GenerateMotionCorpus(json);
+                break;
+            case BENCH_CORPUS_CHECK: {
+                int changed = CheckMotionCorpus(json);
+                ESP_LOGI(TAG, "Motion corpus check: %d plans changed or missed", changed);
+                break;
+            }
+            case BENCH_KERNEL:
+                RunKernelBenchmark(json);
+                break;
+            case BENCH_MOTION:
+                json.reserve(4096);
+                RunMotionBenchmark(job->config, json);
+                break;
+        }
+        ESP_LOGI(TAG, "Benchmark finished in %lld ms", (long long)((esp_timer_get_time() - start_us) / 1000));
+
+        httpd_resp_set_type(job->req, job->kind == BENCH_CORPUS_GENERATE ? "text/plain" : "application/json");
+        httpd_resp_send(job->req, json.c_str(), json.size());
+        httpd_req_async_handler_complete(job->req);
+    }
+    delete job;
+    bench_busy.store(false, std::memory_order_release);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t handle_bench(httpd_req_t *req) {
+    BenchJob *job = new BenchJob{nullptr, BENCH_MOTION, {}};
+    job->config.servo_profile = CyberClock::GetInstance().GetServoMode();
+
+    char query[64] = {0};
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        char value[12] = {0};
+        // corpus=check 对比黄金运动计划，corpus=generate 输出新的 motion_corpus.h；
+        // kernel=1 测量每帧插值内核（PIE 向量版和标量版）的耗时
+        if (httpd_query_key_value(query, "corpus", value, sizeof(value)) == ESP_OK) {
+            job->kind = (strcmp(value, "generate") == 0) ? BENCH_CORPUS_GENERATE : BENCH_CORPUS_CHECK;
+        } else if (httpd_query_key_value(query, "kernel", value, sizeof(value)) == ESP_OK && atoi(value) != 0) {
+            job->kind = BENCH_KERNEL;
+        }
+        if (httpd_query_key_value(query, "profile", value, sizeof(value)) == ESP_OK) {
+            job->config.servo_profile = (strcmp(value, "B") == 0) ? SERVO_PROFILE_B : SERVO_PROFILE_A;
+        }
+        // speed=silent|normal|fast|instant 按速度档位的步长建模
+        if (httpd_query_key_value(query, "speed", value, sizeof(value)) == ESP_OK) {
+            int speed = FindSpeedProfile(value);
+            if (speed != SPEED_NONE) job->config.speed = speed;
+        }
+        // optimize=0 按规划器原始顺序执行，用于对比排序优化前后的耗时
+        if (httpd_query_key_value(query, "optimize", value, sizeof(value)) == ESP_OK) {
+            job->config.optimize_order = atoi(value) != 0;
+        }
+    }
+
+    if (bench_busy.exchange(true, std::memory_order_acquire)) {
+        delete job;
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "Benchmark busy, retry");
+        return ESP_OK;
+    }
+    if (httpd_req_async_handler_begin(req, &job->req) != ESP_OK) {
+        delete job;
+        bench_busy.store(false, std::memory_order_release);
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to start benchmark");
+        return ESP_FAIL;
+    }
+    if (xTaskCreatePinnedToCore(bench_task, "bench_task", 8192, job, BENCH_TASK_PRIORITY, NULL, NETWORK_CORE) != pdPASS) {
+        httpd_resp_send_err(job->req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to start benchmark");
+        httpd_req_async_handler_complete(job->req);
+        delete job;
+        bench_busy.store(false, std::memory_order_release);
+        return ESP_OK;
+    }
+    return ESP_OK;
+}
+
 static esp_err_t handle_default(httpd_req_t *req) {
     char host[64] = {0};
     esp_err_t ret = httpd_req_get_hdr_value_str(req, "Host", host, sizeof(host));
@@ -480,6 +633,12 @@ static esp_err_t handle_get_config(httpd_req_t *req) {
     cJSON_AddNumberToObject(root, "t2h", t2h);
     cJSON_AddNumberToObject(root, "t1m", t1m);
     cJSON_AddNumberToObject(root, "t2m", t2m);
+    // 动画列表和整点动画
+    cJSON_AddStringToObject(root, "hourly_anim", CyberClock::GetInstance().GetHourlyAnimation());
+    cJSON *anims = cJSON_AddArrayToObject(root, "anims");
+    for (int i = 0; i < kAnimationNum; i++) {
+        cJSON_AddItemToArray(anims, cJSON_CreateString(kAnimations[i].name));
+    }
     //读取uuid
     Settings setting_board("board", true);
     std::string uuid_ = setting_board.GetString("uuid", "");
@@ -503,6 +662,385 @@ static esp_err_t handle_get_config(httpd_req_t *req) {
 }
 
 
+// 舵机磨损统计：每个通道 [行程, 移动次数, 负载毫秒, I2C 失败次数]，slow 为每次移动耗时明显偏长的通道
+static esp_err_t handle_telemetry(httpd_req_t *req) {
+    CyberClock& clock = CyberClock::GetInstance();
+    ServoTelemetryBlob blob;
+    if (!clock.GetTelemetry().Read(blob)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "Telemetry busy, retry");
+        return ESP_OK;
+    }
+    int slow[SERVO_CHANNEL_NUM];
+    int slow_num = ServoTelemetry::FindSlowChannels(blob, slow, SERVO_CHANNEL_NUM);
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create JSON");
+        return ESP_FAIL;
+    }
+    cJSON *fields = cJSON_AddArrayToObject(root, "fields");
+    for (const char* field : {"travel", "moves", "load_ms", "i2c_failures"}) {
+        cJSON_AddItemToArray(fields, cJSON_CreateString(field));
+    }
+    cJSON *channels = cJSON_AddArrayToObject(root, "channels");
+    for (int ch = 0; ch < SERVO_CHANNEL_NUM; ch++) {
+        const ServoChannelStats& stats = blob.channels[ch];
+        const int values[4] = {(int)stats.travel, (int)stats.moves, (int)stats.load_ms, (int)stats.i2c_failures};
+        cJSON_AddItemToArray(channels, cJSON_CreateIntArray(values, 4));
+    }
+    cJSON_AddItemToObject(root, "slow", cJSON_CreateIntArray(slow, slow_num));
+    cJSON_AddNumberToObject(root, "saved_s_ago", clock.GetTelemetryAgeSeconds());
+    cJSON_AddNumberToObject(root, "save_interval_min", TELEMETRY_SAVE_INTERVAL_MIN);
+
+    char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json_str);
+    cJSON_Delete(root);
+    free(json_str);
+    return ESP_OK;
+}
+
+// 舵机指令记录：enable=1 开始（清空旧记录），enable=0 停止，download=1 下载二进制文件（见 tools/trace_replay）
+static esp_err_t handle_trace(httpd_req_t *req) {
+    MotionTrace& trace = CyberClock::GetInstance().GetTrace();
+    char query[64] = {0};
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        char value[8] = {0};
+        if (httpd_query_key_value(query, "enable", value, sizeof(value)) == ESP_OK) {
+            if (!trace.Enable(atoi(value) != 0)) {
+                httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "No memory for the trace buffer");
+                return ESP_FAIL;
+            }
+            ESP_LOGI(TAG, "Motion trace %s", trace.Enabled() ? "started" : "stopped");
+        }
+        if (httpd_query_key_value(query, "download", value, sizeof(value)) == ESP_OK && atoi(value) != 0) {
+            size_t size = trace.ExportSize();
+            uint8_t *data = (uint8_t *)malloc(size);
+            if (!data) {
+                httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "No memory for the trace download");
+                return ESP_FAIL;
+            }
+            size = trace.Export(data, size);
+            httpd_resp_set_type(req, "application/octet-stream");
+            httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"motion.trace\"");
+            httpd_resp_send(req, (const char *)data, size);
+            free(data);
+            return ESP_OK;
+        }
+    }
+
+    char json[128];
+    snprintf(json, sizeof(json), "{\"enabled\":%s,\"records\":%u,\"capacity\":%d,\"dropped\":%u}",
+             trace.Enabled() ? "true" : "false", (unsigned)trace.Count(), TRACE_RECORD_NUM - 1, (unsigned)trace.Dropped());
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json);
+    return ESP_OK;
+}
+
+static void AddLatencyStats(cJSON *parent, const char *name, const LatencyStats& stats) {
+    cJSON *item = cJSON_AddObjectToObject(parent, name);
+    cJSON_AddNumberToObject(item, "count", stats.count);
+    cJSON_AddNumberToObject(item, "min_us", stats.min_us);
+    cJSON_AddNumberToObject(item, "mean_us", stats.MeanUs());
+    cJSON_AddNumberToObject(item, "max_us", stats.max_us);
+}
+
+// 自检基准测试（MODE_100_TEST）：start=1 开始，舵机按固定脚本运动；结束后返回各阶段的测量结果
+static esp_err_t handle_selftest(httpd_req_t *req) {
+    CyberClock& clock = CyberClock::GetInstance();
+    char query[32] = {0};
+    char value[8] = {0};
+    bool start = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+                 httpd_query_key_value(query, "start", value, sizeof(value)) == ESP_OK && atoi(value) != 0;
+    // 时钟任务发布的进度和结果快照，读到一半被改写时返回 503
+    SelfTestReport report;
+    if (!start && !clock.GetSelfTest().Report(report)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "Self test busy, retry");
+        return ESP_OK;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create JSON");
+        return ESP_FAIL;
+    }
+    if (start) {
+        clock.StartSelfTest();
+        cJSON_AddStringToObject(root, "state", "started");
+    } else if (report.state == SELFTEST_RUNNING) {
+        cJSON_AddStringToObject(root, "state", "running");
+        cJSON_AddStringToObject(root, "phase", SelfTestPhaseName(report.phase));
+        cJSON_AddNumberToObject(root, "step", report.step);
+    } else if (report.state != SELFTEST_DONE) {
+        cJSON_AddStringToObject(root, "state", "idle");
+    } else {
+        cJSON_AddStringToObject(root, "state", "done");
+        cJSON_AddStringToObject(root, "version", FIRMWARE_VERSION);
+        cJSON_AddStringToObject(root, "kernel", MotionKernelName());
+        cJSON_AddStringToObject(root, "profile", kServoProfiles[clock.GetServoMode()].name);
+        cJSON_AddNumberToObject(root, "channels", SERVO_CHANNEL_NUM);
+        cJSON_AddNumberToObject(root, "drivers", kDisplayTopology.driver_num);
+        cJSON_AddNumberToObject(root, "total_ms", report.total_us / 1000);
+        cJSON *phases = cJSON_AddArrayToObject(root, "phases");
+        for (int phase = 0; phase < SELFTEST_PHASE_NUM; phase++) {
+            const SelfTestPhaseResult& result = report.results[phase];
+            cJSON *item = cJSON_CreateObject();
+            cJSON_AddStringToObject(item, "name", SelfTestPhaseName(phase));
+            cJSON_AddNumberToObject(item, "wall_ms", result.wall_us / 1000);
+            cJSON_AddNumberToObject(item, "busy_pct", result.BusyPercent());
+            AddLatencyStats(item, "i2c", result.i2c);
+            cJSON_AddNumberToObject(item, "i2c_failures", result.i2c_failures);
+            AddLatencyStats(item, "frame", result.frame);
+            AddLatencyStats(item, "transition", result.transition);
+            cJSON_AddNumberToObject(item, "modelled_ms", result.modelled_us / 1000);
+            cJSON_AddItemToArray(phases, item);
+        }
+    }
+
+    char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json_str);
+    cJSON_Delete(root);
+    free(json_str);
+    return ESP_OK;
+}
+
+// 时钟定时器统计：唤醒次数，延迟直方图（第 0 桶 <1ms，第 n 桶 <2^n ms），漏掉的拍数、合并的重复回调、超时的拍数和命令延迟
+static esp_err_t handle_ticks(httpd_req_t *req) {
+    // reset=1 清空动画帧抖动统计，便于在网页压力测试前后各取一次
+    char query[32];
+    char reset[4];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "reset", reset, sizeof(reset)) == ESP_OK && atoi(reset) == 1) {
+        CyberClock::GetInstance().GetFrameJitter().RequestReset();
+    }
+
+    // 时钟任务发布的统计快照，和 /state 一样读到一半被改写时返回 503
+    TickStats stats;
+    CommandLatencyStats commands;
+    JitterStats jitter;
+    DisplayArbiterStats arbiter;
+    if (!CyberClock::GetInstance().GetTickMonitor().Snapshot(stats) ||
+        !CyberClock::GetInstance().GetCommandLatency().Snapshot(commands) ||
+        !CyberClock::GetInstance().GetFrameJitter().Snapshot(jitter) ||
+        !CyberClock::GetInstance().GetDisplayArbiter().Snapshot(arbiter)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "Statistics busy, retry");
+        return ESP_OK;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create JSON");
+        return ESP_FAIL;
+    }
+    cJSON_AddNumberToObject(root, "period_ms", TICK_PERIOD_MS);
+    cJSON_AddNumberToObject(root, "ticks", stats.ticks);
+    cJSON_AddNumberToObject(root, "missed", stats.missed);
+    cJSON_AddNumberToObject(root, "merged", stats.merged);
+    cJSON_AddNumberToObject(root, "overruns", stats.overruns);
+    cJSON_AddNumberToObject(root, "plan_retries", stats.plan_retries);
+    cJSON_AddNumberToObject(root, "max_late_ms", stats.max_late_ms);
+    cJSON_AddNumberToObject(root, "max_run_ms", stats.max_run_ms);
+    int hist[TICK_HIST_BUCKETS];
+    std::copy(stats.late_hist, stats.late_hist + TICK_HIST_BUCKETS, hist);
+    cJSON_AddItemToObject(root, "late_hist", cJSON_CreateIntArray(hist, TICK_HIST_BUCKETS));
+
+    // 唤醒次数：定时器只在显示变化、睡眠计划、遥测保存和收到命令时唤醒
+    cJSON *wakeup_json = cJSON_AddObjectToObject(root, "wakeups");
+    int64_t awake_us = stats.wakeups ? esp_timer_get_time() - stats.first_wakeup_us : 0;
+    cJSON_AddNumberToObject(wakeup_json, "total", stats.wakeups);
+    cJSON_AddNumberToObject(wakeup_json, "by_command", stats.command_wakeups);
+    cJSON_AddNumberToObject(wakeup_json, "this_hour", stats.wakeups_this_hour);
+    cJSON_AddNumberToObject(wakeup_json, "last_hour", stats.wakeups_last_hour);
+    cJSON_AddNumberToObject(wakeup_json, "per_hour", awake_us > 0 ? (double)stats.wakeups * 3600e6 / awake_us : 0);
+
+    // 命令队列：从网页/按键发出到时钟任务执行的延迟，直方图分桶同上
+    cJSON *command_json = cJSON_AddObjectToObject(root, "commands");
+    cJSON_AddNumberToObject(command_json, "applied", commands.applied);
+    cJSON_AddNumberToObject(command_json, "dropped", commands.dropped);
+    cJSON_AddNumberToObject(command_json, "coalesced", commands.coalesced);
+    cJSON_AddNumberToObject(command_json, "mean_us", commands.applied ? (double)(commands.total_us / commands.applied) : 0);
+    cJSON_AddNumberToObject(command_json, "max_us", commands.max_us);
+    int command_hist[COMMAND_LATENCY_BUCKETS];
+    std::copy(commands.hist, commands.hist + COMMAND_LATENCY_BUCKETS, command_hist);
+    cJSON_AddItemToObject(command_json, "latency_hist", cJSON_CreateIntArray(command_hist, COMMAND_LATENCY_BUCKETS));
+
+    // 显示来源仲裁：被更高优先级来源压住的请求、到期的租期和显示权交接次数
+    cJSON *arbiter_json = cJSON_AddObjectToObject(root, "display_sources");
+    cJSON_AddStringToObject(arbiter_json, "owner", DisplaySourceName(arbiter.owner));
+    cJSON_AddNumberToObject(arbiter_json, "claims", arbiter.claims);
+    cJSON_AddNumberToObject(arbiter_json, "deferred", arbiter.deferred);
+    cJSON_AddNumberToObject(arbiter_json, "expired", arbiter.expired);
+    cJSON_AddNumberToObject(arbiter_json, "handovers", arbiter.handovers);
+
+    // 动画帧开始时间相对计划的延迟（第 0 桶 <100us，第 n 桶 <100*2^n us），时钟任务固定在 MOTION_CORE
+    cJSON *jitter_json = cJSON_AddObjectToObject(root, "frame_jitter");
+    cJSON_AddNumberToObject(jitter_json, "core", MOTION_CORE);
+    cJSON_AddNumberToObject(jitter_json, "frames", jitter.frames);
+    cJSON_AddNumberToObject(jitter_json, "mean_us", jitter.frames ? (double)(jitter.total_us / jitter.frames) : 0);
+    cJSON_AddNumberToObject(jitter_json, "max_us", jitter.max_us);
+    int jitter_hist[JITTER_HIST_BUCKETS];
+    std::copy(jitter.hist, jitter.hist + JITTER_HIST_BUCKETS, jitter_hist);
+    cJSON_AddItemToObject(jitter_json, "hist", cJSON_CreateIntArray(jitter_hist, JITTER_HIST_BUCKETS));
+
+    char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json_str);
+    cJSON_Delete(root);
+    free(json_str);
+    return ESP_OK;
+}
+
+// 舵机当前位置、目标位置和模式，一次读取保证彼此一致（seqlock 快照，不阻塞时钟任务）
+static esp_err_t handle_state(httpd_req_t *req) {
+    CyberClock& clock = CyberClock::GetInstance();
+    ClockState state;
+    if (!clock.GetState(state)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "State busy, retry");
+        return ESP_OK;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create JSON");
+        return ESP_FAIL;
+    }
+    cJSON_AddNumberToObject(root, "version", clock.GetStateVersion());
+    cJSON_AddNumberToObject(root, "published_ms", state.published_ms);
+    cJSON_AddNumberToObject(root, "mode", state.mode);
+    cJSON_AddStringToObject(root, "owner", DisplaySourceName(state.owner));
+    cJSON_AddNumberToObject(root, "moves_active", state.moves_active);
+    cJSON_AddNumberToObject(root, "scripts_alive", state.scripts_alive);
+    int position[SERVO_CHANNEL_NUM];
+    int target[SERVO_CHANNEL_NUM];
+    std::copy(state.position, state.position + SERVO_CHANNEL_NUM, position);
+    std::copy(state.target, state.target + SERVO_CHANNEL_NUM, target);
+    cJSON_AddItemToObject(root, "position", cJSON_CreateIntArray(position, SERVO_CHANNEL_NUM));
+    cJSON_AddItemToObject(root, "target", cJSON_CreateIntArray(target, SERVO_CHANNEL_NUM));
+    // 还没到目标位置的通道
+    cJSON *moving = cJSON_AddArrayToObject(root, "moving");
+    for (int channel = 0; channel < SERVO_CHANNEL_NUM; channel++) {
+        if (state.position[channel] != state.target[channel]) {
+            cJSON_AddItemToArray(moving, cJSON_CreateNumber(channel));
+        }
+    }
+
+    char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json_str);
+    cJSON_Delete(root);
+    free(json_str);
+    return ESP_OK;
+}
+
+// 电源管理：每个 PM 锁的持有时间，唤醒到第一次写舵机的延迟（直方图分桶同 /ticks），
+// 以及 esp_pm_dump_locks 的输出（开启 CONFIG_PM_PROFILING 时含各功耗状态的时间）
+static esp_err_t handle_power(httpd_req_t *req) {
+    PowerStats stats;
+    if (!PowerManager::GetInstance().GetMonitor().Snapshot(stats)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "Power statistics busy, retry");
+        return ESP_OK;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create JSON");
+        return ESP_FAIL;
+    }
+#if CONFIG_PM_ENABLE
+    cJSON_AddBoolToObject(root, "pm_enabled", true);
+    cJSON_AddNumberToObject(root, "min_mhz", PM_MIN_CPU_FREQ_MHZ);
+#else
+    cJSON_AddBoolToObject(root, "pm_enabled", false);
+    cJSON_AddNumberToObject(root, "min_mhz", CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#endif
+    cJSON_AddNumberToObject(root, "max_mhz", CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+    cJSON_AddNumberToObject(root, "uptime_ms", (double)(esp_timer_get_time() / 1000));
+
+    cJSON *locks = cJSON_AddArrayToObject(root, "locks");
+    for (int id = 0; id < POWER_LOCK_NUM; id++) {
+        cJSON *lock = cJSON_CreateObject();
+        cJSON_AddStringToObject(lock, "name", PowerLockName(id));
+        cJSON_AddNumberToObject(lock, "acquired", stats.lock[id].acquired);
+        cJSON_AddNumberToObject(lock, "held_ms", (double)(stats.lock[id].held_us / 1000));
+        cJSON_AddNumberToObject(lock, "max_held_us", stats.lock[id].max_held_us);
+        cJSON_AddItemToArray(locks, lock);
+    }
+
+    cJSON *wake = cJSON_AddObjectToObject(root, "wake");
+    cJSON_AddNumberToObject(wake, "count", stats.wake.count);
+    cJSON_AddNumberToObject(wake, "late", stats.wake.late);
+    cJSON_AddNumberToObject(wake, "budget_ms", POWER_WAKE_BUDGET_MS);
+    cJSON_AddNumberToObject(wake, "mean_us", stats.wake.count ? (double)(stats.wake.total_us / stats.wake.count) : 0);
+    cJSON_AddNumberToObject(wake, "max_us", stats.wake.max_us);
+    int hist[POWER_WAKE_BUCKETS];
+    std::copy(stats.wake.hist, stats.wake.hist + POWER_WAKE_BUCKETS, hist);
+    cJSON_AddItemToObject(wake, "latency_hist", cJSON_CreateIntArray(hist, POWER_WAKE_BUCKETS));
+
+    const size_t dump_len = 1536;
+    char *dump = (char *)malloc(dump_len);
+    if (dump) {
+        PowerManager::GetInstance().DumpStates(dump, dump_len);
+        cJSON_AddStringToObject(root, "pm_dump", dump);
+        free(dump);
+    }
+
+    char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json_str);
+    cJSON_Delete(root);
+    free(json_str);
+    return ESP_OK;
+}
+
+// 速度档位：每个模式当前的档位、夜间覆盖，以及每个档位实测的转换耗时（规划 + 舵机移动）和模型估计
+static esp_err_t handle_speed(httpd_req_t *req) {
+    CyberClock& clock = CyberClock::GetInstance();
+    SpeedTransitionStats stats[SPEED_PROFILE_NUM];
+    if (!clock.GetSpeedMonitor().Snapshot(stats)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "Speed statistics busy, retry");
+        return ESP_OK;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to create JSON");
+        return ESP_FAIL;
+    }
+    cJSON *modes = cJSON_AddObjectToObject(root, "modes");
+    for (int speed_mode = 0; speed_mode < SPEED_MODE_NUM; speed_mode++) {
+        cJSON_AddStringToObject(modes, SpeedModeName(speed_mode), kSpeedProfiles[clock.GetModeSpeed(speed_mode)].name);
+    }
+    int night = clock.GetNightSpeed();
+    cJSON_AddStringToObject(root, "night", night == SPEED_NONE ? "none" : kSpeedProfiles[night].name);
+
+    cJSON *profiles = cJSON_AddArrayToObject(root, "profiles");
+    for (int id = 0; id < SPEED_PROFILE_NUM; id++) {
+        const SpeedTransitionStats& s = stats[id];
+        cJSON *profile = cJSON_CreateObject();
+        cJSON_AddStringToObject(profile, "name", kSpeedProfiles[id].name);
+        cJSON_AddNumberToObject(profile, "step", kSpeedProfiles[id].step);
+        cJSON_AddNumberToObject(profile, "transitions", s.transitions);
+        cJSON_AddNumberToObject(profile, "mean_ms", s.transitions ? (double)(s.total_us / s.transitions) / 1000 : 0);
+        cJSON_AddNumberToObject(profile, "max_ms", s.max_us / 1000.0);
+        cJSON_AddNumberToObject(profile, "modelled_mean_ms", s.transitions ? (double)s.modelled_ms / s.transitions : 0);
+        cJSON_AddItemToArray(profiles, profile);
+    }
+
+    char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json_str);
+    cJSON_Delete(root);
+    free(json_str);
+    return ESP_OK;
+}
+
 static esp_err_t handle_captive(httpd_req_t *req) {
     // Captive Portal 探测路径统一302重定向到主页
     httpd_resp_set_status(req, "302 Found");
@@ -534,6 +1072,20 @@ void StopWebServer() {
     }
 }
 
+// 请求处理期间持有 HTTP 电源锁：CPU 保持最高频率，不进入 light sleep
+static esp_err_t handle_with_power_lock(httpd_req_t *req) {
+    PowerLockGuard power_lock(POWER_LOCK_HTTP);
+    esp_err_t (*handler)(httpd_req_t *) = (esp_err_t (*)(httpd_req_t *))req->user_ctx;
+    return handler(req);
+}
+
+// 注册 URI，处理函数经 handle_with_power_lock 调用（原处理函数放在 user_ctx 里）
+static void RegisterUri(httpd_uri_t *uri) {
+    uri->user_ctx = (void *)uri->handler;
+    uri->handler = handle_with_power_lock;
+    httpd_register_uri_handler(web_server_, uri);
+}
+
 void StartWebServer(httpd_handle_t server) {
     ESP_LOGI(TAG, "WebServer.cc StartWebServer...");
 
@@ -551,6 +1103,8 @@ void StartWebServer(httpd_handle_t server) {
         config.max_uri_handlers = 50; // 增加 URI 处理程序的数量
         config.server_port = 80; // 强制HTTP端口为80，确保手机探测可用
         config.stack_size = 8192; // 增大webserver栈空间，兼容复杂页面
+        config.core_id = NETWORK_CORE; // 网页解析不占用时钟任务的核
+        config.task_priority = HTTPD_TASK_PRIORITY;
         if(httpd_start(&web_server_, &config) != ESP_OK) {
             ESP_LOGE(TAG, "Failed to start web server");
             return;
@@ -565,7 +1119,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_index,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_index);
+    RegisterUri(&uri_index);
 
     // 注册 URI 处理程序 - /update.html
     httpd_uri_t uri_update_page = {
@@ -574,7 +1128,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_update_page,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_update_page);
+    RegisterUri(&uri_update_page);
 
     // 注册 URI 处理程序 - /update (处理固件上传)
     httpd_uri_t uri_firmware_upload = {
@@ -583,7 +1137,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_firmware_upload,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_firmware_upload);
+    RegisterUri(&uri_firmware_upload);
 
     // 注册 URI 处理程序 - /adjust.html
     httpd_uri_t uri_adjust_page = {
@@ -592,7 +1146,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_adjust_page,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_adjust_page);
+    RegisterUri(&uri_adjust_page);
 
     // 注册 URI 处理程序 - /timer.html
     httpd_uri_t uri_timer_page = {
@@ -601,7 +1155,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_timer_page,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_timer_page);
+    RegisterUri(&uri_timer_page);
 
     // 注册 factory URI
     httpd_uri_t uri_factory_page = {
@@ -610,7 +1164,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_factory_page,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_factory_page);
+    RegisterUri(&uri_factory_page);
 
     // 注册 /adjust URI
     httpd_uri_t uri_adjust = {
@@ -619,7 +1173,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_adjust,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_adjust);
+    RegisterUri(&uri_adjust);
 
     // 注册 /get_calibration URI
     httpd_uri_t uri_get_calibration = {
@@ -628,7 +1182,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_get_calibration,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_get_calibration);
+    RegisterUri(&uri_get_calibration);
 
     // 注册 URI 处理程序 - /set
     httpd_uri_t uri_set = {
@@ -637,7 +1191,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_set,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_set);
+    RegisterUri(&uri_set);
 
     // 注册 /get_config URI
     httpd_uri_t uri_get_config = {
@@ -646,7 +1200,79 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_get_config,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_get_config);
+    RegisterUri(&uri_get_config);
+
+    // 注册 /bench URI
+    httpd_uri_t uri_bench = {
+        .uri = "/bench",
+        .method = HTTP_GET,
+        .handler = handle_bench,
+        .user_ctx = nullptr
+    };
+    RegisterUri(&uri_bench);
+
+    // 注册 /telemetry URI
+    httpd_uri_t uri_telemetry = {
+        .uri = "/telemetry",
+        .method = HTTP_GET,
+        .handler = handle_telemetry,
+        .user_ctx = nullptr
+    };
+    RegisterUri(&uri_telemetry);
+
+    // 注册 /trace URI
+    httpd_uri_t uri_trace = {
+        .uri = "/trace",
+        .method = HTTP_GET,
+        .handler = handle_trace,
+        .user_ctx = nullptr
+    };
+    RegisterUri(&uri_trace);
+
+    // 注册 /selftest URI
+    httpd_uri_t uri_selftest = {
+        .uri = "/selftest",
+        .method = HTTP_GET,
+        .handler = handle_selftest,
+        .user_ctx = nullptr
+    };
+    RegisterUri(&uri_selftest);
+
+    // 注册 /ticks URI
+    httpd_uri_t uri_ticks = {
+        .uri = "/ticks",
+        .method = HTTP_GET,
+        .handler = handle_ticks,
+        .user_ctx = nullptr
+    };
+    RegisterUri(&uri_ticks);
+
+    // 注册 /state URI
+    httpd_uri_t uri_state = {
+        .uri = "/state",
+        .method = HTTP_GET,
+        .handler = handle_state,
+        .user_ctx = nullptr
+    };
+    RegisterUri(&uri_state);
+
+    // 注册 /power URI
+    httpd_uri_t uri_power = {
+        .uri = "/power",
+        .method = HTTP_GET,
+        .handler = handle_power,
+        .user_ctx = nullptr
+    };
+    RegisterUri(&uri_power);
+
+    // 注册 /speed URI
+    httpd_uri_t uri_speed = {
+        .uri = "/speed",
+        .method = HTTP_GET,
+        .handler = handle_speed,
+        .user_ctx = nullptr
+    };
+    RegisterUri(&uri_speed);
 
     // 注册默认 URI 处理程序
     httpd_uri_t uri_default = {
@@ -655,7 +1281,7 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_default,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_default);
+    RegisterUri(&uri_default);
 
     // 注册 URI 处理程序 - /
     httpd_uri_t uri_root = {
@@ -664,5 +1290,5 @@ void StartWebServer(httpd_handle_t server) {
         .handler = handle_index,
         .user_ctx = nullptr
     };
-    httpd_register_uri_handler(web_server_, &uri_root);
+    RegisterUri(&uri_root);
 }
\ No newline at end of file
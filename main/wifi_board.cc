@@ -80,6 +80,7 @@ void WifiBoard::StartNetwork() {
     // });
     wifi_station.OnConnected([this](const std::string& ssid) {
         ESP_LOGW(TAG, "Connected to WiFi: %s", ssid.c_str());
+        SetPowerSaveMode(true); // Modem sleep between DTIM beacons, required for light sleep
         SyncTime();
     });
 
@@ -0,0 +1,63 @@
+// Runs the motion benchmarks of main/motion_bench.cc on a host and prints the same JSON
+// the clock returns from /bench.
+//
+//     motion_bench [--profile A|B] [--speed silent|normal|fast|instant] [--no-optimize]
+//     motion_bench --kernel
+//     motion_bench --corpus check       exits 1 when a golden plan changed or misses its target,
+//                                       or a script frame outgrew MOTION_SCRIPT_FRAME_SIZE
+//     motion_bench --corpus generate > ../../main/motion_corpus.h
+//
+// Build with the CMakeLists.txt in this directory; ctest runs the corpus check.
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "motion_bench.h"
+#include "motion_planner.h"
+#include "speed_profile.h"
+
+int main(int argc, char** argv) {
+    MotionBenchConfig config;
+    bool kernel = false;
+    const char* corpus = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            config.servo_profile = (strcmp(argv[++i], "B") == 0) ? SERVO_PROFILE_B : SERVO_PROFILE_A;
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            config.speed = FindSpeedProfile(argv[++i]);
+            if (config.speed == SPEED_NONE) {
+                fprintf(stderr, "Unknown speed profile %s\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--no-optimize") == 0) {
+            config.optimize_order = false;
+        } else if (strcmp(argv[i], "--kernel") == 0) {
+            kernel = true;
+        } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            corpus = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--profile A|B] [--speed NAME] [--no-optimize] | --kernel | --corpus check|generate\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::string json;
+    if (corpus && strcmp(corpus, "generate") == 0) {
+        GenerateMotionCorpus(json);
+        fputs(json.c_str(), stdout);
+        return 0;
+    }
+    if (corpus) {
+        int changed = CheckMotionCorpus(json);
+        puts(json.c_str());
+        if (changed > 0) fprintf(stderr, "%d plans differ from motion_corpus.h or miss their target, or frames do not fit\n", changed);
+        return changed > 0 ? 1 : 0;
+    }
+    if (kernel) {
+        RunKernelBenchmark(json);
+    } else {
+        RunMotionBenchmark(config, json);
+    }
+    puts(json.c_str());
+    return 0;
+}
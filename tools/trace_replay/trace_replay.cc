@@ -0,0 +1,220 @@
+// Replays a motion trace recorded by the clock through a host build of the motion engine
+// and draws one timeline per servo channel.
+//
+// Record on the clock, then download:
+//     curl "http://192.168.4.1/trace?enable=1"
+//     curl "http://192.168.4.1/trace?enable=0"
+//     curl -o motion.trace "http://192.168.4.1/trace?download=1"
+//
+// Build and run from this directory:
+//     g++ -std=gnu++20 -O2 -I../../main -o trace_replay trace_replay.cc
+//         ../../main/motion_engine.cc ../../main/display_topology.cc   (one line)
+//     ./trace_replay motion.trace [--csv] [--width N]
+//
+// Every batch of planned moves (TRACE_PLAN) is run through MotionEngine exactly as
+// CyberClock::ExecuteTask does; the writes it produces are compared with the steps the
+// clock recorded (TRACE_STEP) and any divergence is listed. --csv prints the records instead.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "motion_engine.h"
+#include "motion_trace.h"
+
+#define DEFAULT_WIDTH 96        // Timeline columns
+#define DIVERGENCE_LIST_NUM 20  // Divergences printed in full
+
+namespace {
+
+struct Write {
+    int channel;
+    int position;
+};
+
+class RecordingOutput : public MotionOutput {
+public:
+    void WriteChannel(int channel, int position) override { writes.push_back({channel, position}); }
+    std::vector<Write> writes;
+};
+
+bool ReadTrace(const char* path, TraceHeader& header, std::vector<TraceRecord>& records) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+    bool ok = fread(&header, sizeof(header), 1, file) == 1;
+    if (!ok || header.magic != TRACE_MAGIC || header.version != TRACE_VERSION ||
+        header.record_size != sizeof(TraceRecord)) {
+        fprintf(stderr, "%s is not a version %d motion trace\n", path, TRACE_VERSION);
+        fclose(file);
+        return false;
+    }
+    records.resize(header.record_num);
+    size_t read = fread(records.data(), sizeof(TraceRecord), records.size(), file);
+    fclose(file);
+    if (read != records.size()) {
+        fprintf(stderr, "%s is truncated: %zu of %u records\n", path, read, (unsigned)header.record_num);
+        records.resize(read);
+    }
+    return true;
+}
+
+const char* ReasonName(int reason) {
+    switch (reason & TRACE_REASON_MASK) {
+        case TRACE_PLAN: return "plan";
+        case TRACE_STEP: return "step";
+        case TRACE_FRAME: return "frame";
+        default: return "?";
+    }
+}
+
+void PrintCsv(const std::vector<TraceRecord>& records) {
+    printf("time_ms,channel,reason,position,from,front0,front1,step,avoidance\n");
+    for (const TraceRecord& record : records) {
+        printf("%u,%d,%s,%d,%d,%d,%d,%d,%d\n", (unsigned)record.time_ms, record.channel, ReasonName(record.reason),
+               record.position, record.from, record.fronts[0], record.fronts[1],
+               record.step, (record.reason & TRACE_FLAG_AVOIDANCE) ? 1 : 0);
+    }
+}
+
+// Runs each batch of planned moves to completion and checks it against the recorded steps.
+// Returns the number of divergent writes.
+int Replay(const std::vector<TraceRecord>& records) {
+    MotionEngine engine;
+    int positions[SERVO_CHANNEL_NUM] = {0};
+    int batches = 0;
+    int divergences = 0;
+    size_t i = 0;
+    while (i < records.size()) {
+        if ((records[i].reason & TRACE_REASON_MASK) != TRACE_PLAN) {
+            if ((records[i].reason & TRACE_REASON_MASK) == TRACE_FRAME && records[i].channel < SERVO_CHANNEL_NUM) {
+                positions[records[i].channel] = records[i].position;
+            }
+            i++;
+            continue;
+        }
+
+        // Consecutive plans form one batch, the clock runs them in one ExecuteTask
+        const size_t batch_start = i;
+        for (; i < records.size() && (records[i].reason & TRACE_REASON_MASK) == TRACE_PLAN; i++) {
+            const TraceRecord& record = records[i];
+            ServoState task;
+            task.channel = record.channel;
+            task.current_position = record.from;
+            task.target_position = record.position;
+            task.front_channels[0] = record.fronts[0];
+            task.front_channels[1] = record.fronts[1];
+            task.step = record.step > 0 ? record.step : SERVO_STEP_FAST;
+            task.avoidance = record.reason & TRACE_FLAG_AVOIDANCE;
+            if (task.channel < SERVO_CHANNEL_NUM) positions[task.channel] = task.current_position;
+            if (!engine.AddTask(task)) {
+                fprintf(stderr, "Record %zu: no script frame free, batch skipped\n", i);
+            }
+        }
+
+        RecordingOutput output;
+        int simulated_ms = 0;
+        bool tasks_remaining = !engine.Empty();
+        while (tasks_remaining) {
+            MotionRound round = engine.RunRound(positions, output);
+            tasks_remaining = round.tasks_remaining;
+            simulated_ms += round.tasks_executed * SERVO_STEP_DELAY_MS;
+            if (!round.restart) simulated_ms += SERVO_STEP_DELAY_MS;
+        }
+
+        // Recorded steps up to the next plan
+        size_t step = i;
+        size_t matched = 0;
+        uint32_t first_ms = 0, last_ms = 0;
+        for (; step < records.size() && (records[step].reason & TRACE_REASON_MASK) != TRACE_PLAN; step++) {
+            const TraceRecord& record = records[step];
+            if ((record.reason & TRACE_REASON_MASK) != TRACE_STEP) continue;
+            if (matched == 0) first_ms = record.time_ms;
+            last_ms = record.time_ms;
+            if (matched < output.writes.size()) {
+                const Write& expected = output.writes[matched];
+                if (expected.channel != record.channel || expected.position != record.position) {
+                    if (divergences < DIVERGENCE_LIST_NUM) {
+                        printf("divergence at %u ms: write %zu of batch %d, replay ch%d=%d, clock ch%d=%d\n",
+                               (unsigned)record.time_ms, matched, batches, expected.channel, expected.position,
+                               record.channel, record.position);
+                    }
+                    divergences++;
+                }
+            }
+            matched++;
+        }
+        if (matched != output.writes.size()) {
+            printf("batch %d at %u ms: replay wrote %zu positions, clock %zu%s\n", batches,
+                   (unsigned)records[batch_start].time_ms, output.writes.size(), matched,
+                   step == records.size() ? " (trace ends)" : "");
+            divergences += abs((int)matched - (int)output.writes.size());
+        }
+        printf("batch %d at %u ms: %zu moves, %zu writes, replay %d ms, clock %u ms\n", batches,
+               (unsigned)records[batch_start].time_ms, i - batch_start, output.writes.size(), simulated_ms,
+               matched ? (unsigned)(last_ms - first_ms + SERVO_STEP_DELAY_MS) : 0);
+        batches++;
+    }
+    printf("%d batches replayed, %d divergent writes\n", batches, divergences);
+    return divergences;
+}
+
+// One row per channel that moved: each column is a time slice, the digit the last
+// position written in it (0 = SERVO_POSITION_MIN .. 9 = SERVO_POSITION_MAX), '.' for none
+void PrintTimelines(const std::vector<TraceRecord>& records, int width) {
+    if (records.empty()) return;
+    const uint32_t start = records.front().time_ms;
+    const uint32_t span = std::max<uint32_t>(records.back().time_ms - start, 1);
+    printf("\ntimelines, %u ms per column\n", (unsigned)((span + width - 1) / width));
+
+    for (int ch = 0; ch < SERVO_CHANNEL_NUM; ch++) {
+        std::vector<char> row(width, '.');
+        bool moved = false;
+        for (const TraceRecord& record : records) {
+            if (record.channel != ch || (record.reason & TRACE_REASON_MASK) == TRACE_PLAN) continue;
+            int column = (int)((uint64_t)(record.time_ms - start) * (width - 1) / span);
+            int level = (record.position - SERVO_POSITION_MIN) * 10 / (SERVO_POSITION_MAX - SERVO_POSITION_MIN + 1);
+            row[column] = '0' + std::max(0, std::min(level, 9));
+            moved = true;
+        }
+        if (moved) printf("d%d s%d ch%-3d %.*s\n", ch / SEGMENTS_PER_DIGIT, ch % SEGMENTS_PER_DIGIT, ch, width,
+                          row.data());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool csv = false;
+    int width = DEFAULT_WIDTH;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            width = std::max(atoi(argv[++i]), 8);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s motion.trace [--csv] [--width N]\n", argv[0]);
+        return 2;
+    }
+
+    TraceHeader header;
+    std::vector<TraceRecord> records;
+    if (!ReadTrace(path, header, records)) return 2;
+    if (csv) {
+        PrintCsv(records);
+        return 0;
+    }
+
+    printf("%zu records, %u dropped before the first\n", records.size(), (unsigned)header.dropped);
+    int divergences = Replay(records);
+    PrintTimelines(records, width);
+    return divergences ? 1 : 0;
+}